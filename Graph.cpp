@@ -1,4 +1,26 @@
 #include "Graph.h"
+#include "allPairs.h"
+#include "parkingIndex.h"
+#include "components.h"
+#include "biconnectivity.h"
+#include "landmarks.h"
+#include "treeCache.h"
+#include "turns.h"
+#include "partitionOverlay.h"
+#include <algorithm>
+
+/*
+ * Auxiliary function to remove a given edge from an edge list, keeping the order of the others.
+ * Returns true if the edge was found.
+ */
+
+static bool eraseEdge(std::vector<Edge *> &edges, const Edge *edge) {
+    auto it = std::find(edges.begin(), edges.end(), edge);
+    if (it == edges.end())
+        return false;
+    edges.erase(it);
+    return true;
+}
 
 /************************* Vertex  **************************/
 
@@ -58,7 +80,7 @@ bool Vertex::operator<(Vertex & vertex) const {
     return this->dist < vertex.dist;
 }
 
-std::string Vertex::getLocation() const {
+const std::string &Vertex::getLocation() const {
     return this->location;
 }
 
@@ -66,7 +88,7 @@ int Vertex::getId() const {
     return this->id;
 }
 
-std::string Vertex::getCode() const {
+const std::string &Vertex::getCode() const {
     return this->code;
 }
 
@@ -74,6 +96,10 @@ bool Vertex::getParking() const {
     return this->parking;
 }
 
+int Vertex::getIndex() const {
+    return this->index;
+}
+
 int Vertex::getLow() const {
     return this->low;
 }
@@ -90,7 +116,7 @@ void Vertex::setNum(int value) {
     this->num = value;
 }
 
-std::vector<Edge*> Vertex::getAdj() const {
+const std::vector<Edge *> &Vertex::getAdj() const {
     return this->adj;
 }
 
@@ -114,7 +140,7 @@ Edge *Vertex::getPath() const {
     return this->path;
 }
 
-std::vector<Edge *> Vertex::getIncoming() const {
+const std::vector<Edge *> &Vertex::getIncoming() const {
     return this->incoming;
 }
 
@@ -138,18 +164,17 @@ void Vertex::setPath(Edge *path) {
     this->path = path;
 }
 
+bool Vertex::isClosed() const {
+    return this->closed;
+}
+
 void Vertex::deleteEdge(Edge *edge) {
     Vertex *dest = edge->getDest();
     // Remove the corresponding edge from the incoming list
-    auto it = dest->incoming.begin();
-    while (it != dest->incoming.end()) {
-        if ((*it)->getOrig()->getId() == id) {
-            it = dest->incoming.erase(it);
-        }
-        else {
-            it++;
-        }
-    }
+    if (!eraseEdge(dest->incoming, edge))
+        eraseEdge(dest->closedIncoming, edge);
+    if (edge->getReverse() != nullptr)
+        edge->getReverse()->setReverse(nullptr);
     delete edge;
 }
 
@@ -169,6 +194,10 @@ int Edge::getWalking() const {
     return this->walking;
 }
 
+int Edge::getWeight(Metric metric) const {
+    return metric == Metric::Driving ? this->driving : this->walking;
+}
+
 Vertex * Edge::getOrig() const {
     return this->orig;
 }
@@ -197,13 +226,17 @@ void Edge::setFlow(double flow) {
     this->flow = flow;
 }
 
+bool Edge::isClosed() const {
+    return this->closed;
+}
+
 /********************** Graph  ****************************/
 
 int Graph::getNumVertex() const {
     return vertexSet.size();
 }
 
-std::vector<Vertex *> Graph::getVertexSet() const {
+const std::vector<Vertex *> &Graph::getVertexSet() const {
     return vertexSet;
 }
 
@@ -211,17 +244,13 @@ std::vector<Vertex *> Graph::getVertexSet() const {
  * Auxiliary function to find a vertex with a given content.
  */
 Vertex * Graph::findVertexById(const int id) const {
-    for (auto v : vertexSet)
-        if (v->getId() == id)
-            return v;
-    return nullptr;
+    auto it = idIndex.find(id);
+    return it == idIndex.end() ? nullptr : it->second;
 }
 
 Vertex * Graph::findVertexByCode(const std::string &code) const {
-    for (auto v : vertexSet)
-        if (v->getCode() == code)
-            return v;
-    return nullptr;
+    auto it = codeIndex.find(code);
+    return it == codeIndex.end() ? nullptr : it->second;
 }
 
 
@@ -233,7 +262,13 @@ Vertex * Graph::findVertexByCode(const std::string &code) const {
 bool Graph::addVertex(const std::string &location, int id, const std::string &code, const bool parking) {
     if (findVertexById(id) != nullptr)
         return false;
-    vertexSet.push_back(new Vertex(location, id, code, parking));
+    dropPrecomputed();
+    setOverlay(nullptr);
+    auto v = new Vertex(location, id, code, parking);
+    v->index = vertexSet.size();
+    vertexSet.push_back(v);
+    idIndex[id] = v;
+    codeIndex.emplace(code, v);
     return true;
 }
 
@@ -244,19 +279,65 @@ bool Graph::addVertex(const std::string &location, int id, const std::string &co
  */
 
 bool Graph::removeVertex(const int &id) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); it++) {
-        if ((*it)->getId() == id) {
-            auto v = *it;
-            v->removeOutgoingEdges();
-            for (auto u : vertexSet) {
-                u->removeEdge(v->getId());
-            }
-            vertexSet.erase(it);
-            delete v;
-            return true;
-        }
+    auto v = findVertexById(id);
+    if (v == nullptr)
+        return false;
+
+    dropPrecomputed();
+    setOverlay(nullptr);
+    std::vector<Edge *> edges;
+    for (auto list : {&v->adj, &v->closedAdj, &v->incoming, &v->closedIncoming})
+        edges.insert(edges.end(), list->begin(), list->end());
+
+    closedSegments.erase(std::remove_if(closedSegments.begin(), closedSegments.end(), [v](Edge *e) {
+        return e->getOrig() == v || e->getDest() == v;
+    }), closedSegments.end());
+    closedVertices.erase(std::remove(closedVertices.begin(), closedVertices.end(), v), closedVertices.end());
+
+    for (auto e : edges) {
+        unlinkEdge(e);
+        if (e->getReverse() != nullptr)
+            e->getReverse()->setReverse(nullptr);
+        delete e;
     }
-    return false;
+
+    vertexSet.erase(vertexSet.begin() + v->index);
+    for (size_t i = v->index; i < vertexSet.size(); i++)
+        vertexSet[i]->index = i;
+    idIndex.erase(v->getId());
+    if (findVertexByCode(v->getCode()) == v)
+        codeIndex.erase(v->getCode());
+    delete v;
+    return true;
+}
+
+
+/*
+ *  Renumbers the dense indices: order[i] is the current index of the vertex that gets index i.
+ *  IDs and codes are kept. Precomputed matrices and indexes use positions, so they are dropped.
+ *  Returns false, without changes, if order is not a permutation of the indices.
+ */
+
+bool Graph::reorderVertices(const std::vector<int> &order) {
+    if (order.size() != vertexSet.size())
+        return false;
+    std::vector<bool> seen(order.size(), false);
+    for (int i : order) {
+        if (i < 0 || i >= (int)order.size() || seen[i])
+            return false;
+        seen[i] = true;
+    }
+
+    dropPrecomputed();
+    setOverlay(nullptr);
+    std::vector<Vertex *> reordered;
+    reordered.reserve(order.size());
+    for (int i : order)
+        reordered.push_back(vertexSet[i]);
+    vertexSet = std::move(reordered);
+    for (size_t i = 0; i < vertexSet.size(); i++)
+        vertexSet[i]->index = i;
+    return true;
 }
 
 
@@ -265,6 +346,8 @@ bool Graph::addBidirectionalEdge(const std::string &code1, const std::string &co
     auto v2 = findVertexByCode(code2);
     if (v1 == nullptr || v2 == nullptr)
         return false;
+    dropPrecomputed();
+    setOverlay(nullptr);
     auto e1 = v1->addEdge(v2, driving, walking);
     auto e2 = v2->addEdge(v1, driving, walking);
     e1->setReverse(e2);
@@ -272,25 +355,354 @@ bool Graph::addBidirectionalEdge(const std::string &code1, const std::string &co
     return true;
 }
 
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+/*
+ * An edge is active, and therefore present in the adjacency and incoming lists,
+ * when neither of its endpoints nor the segment itself is closed.
+ */
+
+bool Graph::isActive(const Edge *edge) {
+    return !edge->closed && !edge->orig->closed && !edge->dest->closed;
+}
+
+void Graph::detachEdge(Edge *edge) {
+    eraseEdge(edge->orig->adj, edge);
+    edge->orig->closedAdj.push_back(edge);
+    eraseEdge(edge->dest->incoming, edge);
+    edge->dest->closedIncoming.push_back(edge);
+}
+
+void Graph::attachEdge(Edge *edge) {
+    eraseEdge(edge->orig->closedAdj, edge);
+    edge->orig->adj.push_back(edge);
+    eraseEdge(edge->dest->closedIncoming, edge);
+    edge->dest->incoming.push_back(edge);
+}
+
+void Graph::unlinkEdge(Edge *edge) {
+    if (!eraseEdge(edge->orig->adj, edge))
+        eraseEdge(edge->orig->closedAdj, edge);
+    if (!eraseEdge(edge->dest->incoming, edge))
+        eraseEdge(edge->dest->closedIncoming, edge);
+}
+
+/*
+ *  Closes a location: every edge leaving or entering it is detached from its neighbours.
+ *  The vertex itself stays in the graph, so it can be reopened later.
+ *  Returns false if the vertex does not exist or is already closed.
+ */
+
+bool Graph::closeVertex(int id) {
+    auto v = findVertexById(id);
+    if (v == nullptr || v->closed)
+        return false;
+
+    std::vector<Edge *> edges(v->adj);
+    edges.insert(edges.end(), v->incoming.begin(), v->incoming.end());
+    while (!v->adj.empty())
+        detachEdge(v->adj.back());
+    while (!v->incoming.empty())
+        detachEdge(v->incoming.back());
+
+    v->closed = true;
+    closedVertices.push_back(v);
+    closureKey += closureHash(v->getId(), -1);
+    if (components != nullptr)
+        components->detached(edges, v);
+    return true;
+}
+
+/*
+ *  Reopens a closed location, attaching back the edges whose other endpoint and segment are open.
+ */
+
+bool Graph::reopenVertex(int id) {
+    auto v = findVertexById(id);
+    if (v == nullptr || !v->closed)
+        return false;
+
+    v->closed = false;
+    closureKey -= closureHash(v->getId(), -1);
+    std::vector<Edge *> edges;
+    for (auto e : std::vector<Edge *>(v->closedAdj))
+        if (isActive(e))
+            edges.push_back(e);
+    for (auto e : std::vector<Edge *>(v->closedIncoming))
+        if (isActive(e))
+            edges.push_back(e);
+    for (auto e : edges)
+        attachEdge(e);
+
+    if (components != nullptr)
+        components->attached(edges, v);
+    return true;
+}
+
+/*
+ *  Closes the segment between two locations, in both directions.
+ *  Returns false if no such segment exists.
+ */
+
+bool Graph::closeSegment(int id1, int id2) {
+    auto v1 = findVertexById(id1);
+    if (v1 == nullptr)
+        return false;
+
+    std::vector<Edge *> edges;
+    for (auto list : {&v1->adj, &v1->closedAdj})
+        for (auto e : *list)
+            if (e->dest->getId() == id2)
+                edges.push_back(e);
+
+    std::vector<Edge *> detached;
+    for (auto e : edges) {
+        for (auto edge : {e, e->reverse}) {
+            if (edge == nullptr || edge->closed)
+                continue;
+            if (isActive(edge)) {
+                detachEdge(edge);
+                detached.push_back(edge);
+            }
+            edge->closed = true;
+            closedSegments.push_back(edge);
+            closureKey += closureHash(edge->orig->getId(), edge->dest->getId());
+        }
     }
+
+    if (components != nullptr && !detached.empty())
+        components->detached(detached);
+    return !edges.empty();
 }
 
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+bool Graph::reopenSegment(int id1, int id2) {
+    auto v1 = findVertexById(id1);
+    if (v1 == nullptr)
+        return false;
+
+    std::vector<Edge *> edges;
+    for (auto e : v1->closedAdj)
+        if (e->dest->getId() == id2 && e->closed)
+            edges.push_back(e);
+
+    std::vector<Edge *> attached;
+    for (auto e : edges) {
+        for (auto edge : {e, e->reverse}) {
+            if (edge == nullptr || !edge->closed)
+                continue;
+            edge->closed = false;
+            closureKey -= closureHash(edge->orig->getId(), edge->dest->getId());
+            if (isActive(edge)) {
+                attachEdge(edge);
+                attached.push_back(edge);
+            }
+        }
     }
+
+    if (components != nullptr && !attached.empty())
+        components->attached(attached);
+    return !edges.empty();
+}
+
+/*
+ *  Changes the driving and walking times of the segment between two locations, in both directions
+ *  (for example, from a traffic feed). Precomputed matrices and indexes no longer apply and are dropped,
+ *  and the overlay (see partitionOverlay.h) has to be customized again.
+ *  Returns false if no such segment exists.
+ */
+
+bool Graph::setSegmentWeights(int id1, int id2, int driving, int walking) {
+    auto v1 = findVertexById(id1);
+    if (v1 == nullptr)
+        return false;
+
+    bool found = false;
+    for (auto list : {&v1->adj, &v1->closedAdj}) {
+        for (auto e : *list) {
+            if (e->dest->getId() != id2)
+                continue;
+            for (auto edge : {e, e->reverse}) {
+                if (edge != nullptr) {
+                    edge->driving = driving;
+                    edge->walking = walking;
+                }
+            }
+            found = true;
+        }
+    }
+
+    if (found)
+        dropPrecomputed();
+    return found;
+}
+
+void Graph::closeVertices(const std::vector<int> &ids) {
+    for (int id : ids)
+        closeVertex(id);
+}
+
+void Graph::closeSegments(const std::vector<std::pair<int, int>> &segments) {
+    for (auto &s : segments)
+        closeSegment(s.first, s.second);
+}
+
+/*
+ *  Reopens every location and segment closed since the graph was loaded (or since the last call).
+ */
+
+void Graph::reopenAll() {
+    std::vector<Edge *> attached;
+    for (auto e : closedSegments) {
+        if (!e->closed)
+            continue;
+        e->closed = false;
+        closureKey -= closureHash(e->orig->getId(), e->dest->getId());
+        if (isActive(e)) {
+            attachEdge(e);
+            attached.push_back(e);
+        }
+    }
+    if (components != nullptr && !attached.empty())
+        components->attached(attached);
+
+    for (auto v : closedVertices)
+        if (v->closed)
+            reopenVertex(v->getId());
+
+    closedSegments.clear();
+    closedVertices.clear();
+}
+
+bool Graph::hasClosures() const {
+    return !closedVertices.empty() || !closedSegments.empty();
+}
+
+/*
+ *  Fingerprint of the locations and segments closed right now, whatever the order they were closed in:
+ *  the sum of a 64-bit hash of each closed location and each closed direction of a segment.
+ */
+
+unsigned long long Graph::getClosureKey() const {
+    return closureKey;
+}
+
+unsigned long long Graph::closureHash(int id1, int id2) {
+    unsigned long long x = (unsigned long long)(unsigned int)id1 << 32 | (unsigned int)id2;
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/*
+ *  All-pairs matrices (see allPairs.h), the parking index (see parkingIndex.h), the component labels
+ *  (see components.h), the biconnectivity index (see biconnectivity.h) and the landmarks (see landmarks.h) are
+ *  owned by the graph and dropped whenever vertices, edges or weights change, since they would no longer match
+ *  it. The component labels are kept up to date under closures, and landmark bounds stay valid under them.
+ *  The shortest path tree cache (see treeCache.h) is kept, but emptied. The turn rules (see turns.h) are map
+ *  data rather than derived data, and refer to locations by ID, so they are kept.
+ */
+
+AllPairsMatrix *Graph::getMatrix(Metric metric) const {
+    return metric == Metric::Driving ? drivingMatrix : walkingMatrix;
+}
+
+void Graph::setMatrix(Metric metric, AllPairsMatrix *matrix) {
+    AllPairsMatrix *&current = metric == Metric::Driving ? drivingMatrix : walkingMatrix;
+    if (current != matrix)
+        delete current;
+    current = matrix;
+}
+
+ParkingIndex *Graph::getParkingIndex() const {
+    return parkingIndex;
+}
+
+void Graph::setParkingIndex(ParkingIndex *index) {
+    if (parkingIndex != index)
+        delete parkingIndex;
+    parkingIndex = index;
+}
+
+ComponentIndex *Graph::getComponents() const {
+    return components;
+}
+
+void Graph::setComponents(ComponentIndex *index) {
+    if (components != index)
+        delete components;
+    components = index;
+}
+
+BiconnectivityIndex *Graph::getBiconnectivity() const {
+    return biconnectivity;
+}
+
+void Graph::setBiconnectivity(BiconnectivityIndex *index) {
+    if (biconnectivity != index)
+        delete biconnectivity;
+    biconnectivity = index;
+}
+
+LandmarkIndex *Graph::getLandmarks() const {
+    return landmarks;
+}
+
+void Graph::setLandmarks(LandmarkIndex *index) {
+    if (landmarks != index)
+        delete landmarks;
+    landmarks = index;
+}
+
+ShortestPathTreeCache *Graph::getTreeCache() const {
+    return treeCache;
+}
+
+void Graph::setTreeCache(ShortestPathTreeCache *cache) {
+    if (treeCache != cache)
+        delete treeCache;
+    treeCache = cache;
+}
+
+TurnTable *Graph::getTurns() const {
+    return turns;
+}
+
+void Graph::setTurns(TurnTable *table) {
+    if (turns != table)
+        delete turns;
+    turns = table;
+}
+
+OverlayGraph *Graph::getOverlay() const {
+    return overlay;
+}
+
+void Graph::setOverlay(OverlayGraph *graph) {
+    if (overlay != graph)
+        delete overlay;
+    overlay = graph;
+}
+
+/*
+ *  The overlay partition only depends on the topology, so it is kept and only needs customizing again;
+ *  adding, removing or renumbering vertices and edges drops it.
+ */
+
+void Graph::dropPrecomputed() {
+    setMatrix(Metric::Driving, nullptr);
+    setMatrix(Metric::Walking, nullptr);
+    setParkingIndex(nullptr);
+    setComponents(nullptr);
+    setBiconnectivity(nullptr);
+    setLandmarks(nullptr);
+    if (treeCache != nullptr)
+        treeCache->clear();
+    if (overlay != nullptr)
+        overlay->invalidate();
 }
 
 Graph::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    dropPrecomputed();
+    setTreeCache(nullptr);
+    setTurns(nullptr);
+    setOverlay(nullptr);
 }
@@ -9,9 +9,26 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "MutablePriorityQueue.h"
 
 class Edge;
+class AllPairsMatrix;
+class ParkingIndex;
+class ComponentIndex;
+class BiconnectivityIndex;
+class ShortestPathTreeCache;
+class TurnTable;
+class LandmarkIndex;
+class OverlayGraph;
+
+/**
+ * @brief Edge weight used by a search.
+ */
+enum class Metric {
+    Driving,
+    Walking
+};
 
 /**
  * @brief Class representing a vertex in the graph.
@@ -27,6 +44,7 @@ protected:
     int id;
     std::string code;
     bool parking;
+    int index = 0; // dense position in the graph's vertex set
 
     bool visited;
     bool processing;
@@ -38,17 +56,22 @@ protected:
     std::vector<Edge *> adj;
     std::vector<Edge *> incoming;
 
+    // Edges taken out of adj/incoming by a closure, kept so they can be reopened
+    bool closed = false;
+    std::vector<Edge *> closedAdj;
+    std::vector<Edge *> closedIncoming;
 
 public:
     Vertex(const std::string &location, int id, const std::string &code, bool parking);
 
-    std::string getLocation() const;
+    const std::string &getLocation() const;
     int getId() const;
-    std::string getCode() const;
+    const std::string &getCode() const;
     bool getParking() const;
+    int getIndex() const;
 
-    std::vector<Edge *> getIncoming() const;
-    std::vector<Edge *> getAdj() const;
+    const std::vector<Edge *> &getIncoming() const;
+    const std::vector<Edge *> &getAdj() const;
 
     bool isVisited() const;
     void setVisited(bool visited);
@@ -64,6 +87,7 @@ public:
     void setNum(int value);
     Edge * getPath() const;
     void setPath(Edge * path);
+    bool isClosed() const;
 
     Edge * addEdge(Vertex *d, int driving, int walking);
     bool removeEdge(int id);
@@ -71,6 +95,7 @@ public:
     void deleteEdge(Edge *edge);
 
     friend class MutablePriorityQueue<Vertex>;
+    friend class Graph;
 
     bool operator<(Vertex &vertex) const;
 
@@ -90,6 +115,7 @@ protected:
     int driving;
     int walking;
     bool selected = false;
+    bool closed = false;
     double flow;
     Edge *reverse = nullptr;
 
@@ -99,14 +125,18 @@ public:
     Vertex *getDest() const;
     int getDriving() const;
     int getWalking() const;
+    int getWeight(Metric metric) const;
     bool isSelected() const;
     Vertex *getOrig() const;
     Edge *getReverse() const;
     double getFlow() const;
+    bool isClosed() const;
 
     void setSelected(bool selected);
     void setReverse(Edge *reverse);
     void setFlow(double flow);
+
+    friend class Graph;
 };
 
 
@@ -115,12 +145,36 @@ public:
  *
  * A graph consists of a set of vertices and edges connecting them. The class provides methods
  * for adding vertices and edges, as well as finding vertices by ID or code.
+ *
+ * Locations and road segments can be closed and reopened without reloading the graph. A closure
+ * detaches the affected edges from the adjacency and incoming lists, so the search algorithms never
+ * see them, and parks them in the vertex so they can be attached again later. Using the incoming
+ * lists and reverse edges, each edit costs O(degree).
  */
 class Graph {
 protected:
     std::vector<Vertex *> vertexSet;
-    double **distMatrix = nullptr;
-    int **pathMatrix = nullptr;
+    std::unordered_map<int, Vertex *> idIndex;
+    std::unordered_map<std::string, Vertex *> codeIndex;
+    std::vector<Vertex *> closedVertices;
+    std::vector<Edge *> closedSegments;
+    unsigned long long closureKey = 0;
+    AllPairsMatrix *drivingMatrix = nullptr;
+    AllPairsMatrix *walkingMatrix = nullptr;
+    ParkingIndex *parkingIndex = nullptr;
+    ComponentIndex *components = nullptr;
+    BiconnectivityIndex *biconnectivity = nullptr;
+    LandmarkIndex *landmarks = nullptr;
+    ShortestPathTreeCache *treeCache = nullptr;
+    TurnTable *turns = nullptr;
+    OverlayGraph *overlay = nullptr;
+
+    static bool isActive(const Edge *edge);
+    static void detachEdge(Edge *edge);
+    static void attachEdge(Edge *edge);
+    static void unlinkEdge(Edge *edge);
+    static unsigned long long closureHash(int id1, int id2);
+    void dropPrecomputed();
 
 public:
     ~Graph();
@@ -130,9 +184,38 @@ public:
 
     bool addVertex(const std::string &location, int id, const std::string &code, bool parking);
     bool removeVertex(const int &id);
+    bool reorderVertices(const std::vector<int> &order);
     bool addBidirectionalEdge(const std::string &code1, const std::string &code2, int driving, int walking);
 
-    std::vector<Vertex *> getVertexSet() const;
+    bool closeVertex(int id);
+    bool reopenVertex(int id);
+    bool closeSegment(int id1, int id2);
+    bool reopenSegment(int id1, int id2);
+    bool setSegmentWeights(int id1, int id2, int driving, int walking);
+    void closeVertices(const std::vector<int> &ids);
+    void closeSegments(const std::vector<std::pair<int, int>> &segments);
+    void reopenAll();
+    bool hasClosures() const;
+    unsigned long long getClosureKey() const;
+
+    AllPairsMatrix *getMatrix(Metric metric) const;
+    void setMatrix(Metric metric, AllPairsMatrix *matrix);
+    ParkingIndex *getParkingIndex() const;
+    void setParkingIndex(ParkingIndex *index);
+    ComponentIndex *getComponents() const;
+    void setComponents(ComponentIndex *index);
+    BiconnectivityIndex *getBiconnectivity() const;
+    void setBiconnectivity(BiconnectivityIndex *index);
+    LandmarkIndex *getLandmarks() const;
+    void setLandmarks(LandmarkIndex *index);
+    ShortestPathTreeCache *getTreeCache() const;
+    void setTreeCache(ShortestPathTreeCache *cache);
+    TurnTable *getTurns() const;
+    void setTurns(TurnTable *table);
+    OverlayGraph *getOverlay() const;
+    void setOverlay(OverlayGraph *graph);
+
+    const std::vector<Vertex *> &getVertexSet() const;
 
     int getNumVertex() const;
 };
@@ -112,4 +112,8 @@ void MutablePriorityQueue<T>::set(unsigned i, T * x) {
     x->queueIndex = i;
 }
 
+// The index macros are only needed by the definitions above
+#undef parent
+#undef leftChild
+
 #endif
\ No newline at end of file
@@ -1,98 +1,90 @@
 #include "algorithms.h"
+#include "deltaStepping.h"
+#include "allPairs.h"
+#include "waypoints.h"
+#include "parkingIndex.h"
+#include "components.h"
+#include "biconnectivity.h"
+#include "treeCache.h"
+#include "turns.h"
+#include "landmarks.h"
+#include "partitionOverlay.h"
+#include "searchKernel.h"
+#include "deadline.h"
+#include "trace.h"
+#include "queryLog.h"
 #include <iostream>
 #include <algorithm>
 #include <climits>
 
-void dijkstraWalking(Graph * graph, int source) {
-	Vertex * src = graph->findVertexById(source);
+// Options suggested when none fits the maximum walking time of a driving and walking plan
+const int DRIVING_WALKING_SUGGESTIONS = 2;
 
-	if (!src) {
-		return;
-	}
-
-	for (auto v : graph->getVertexSet()) {
-		v->setDist(INT_MAX);
-		v->setVisited(false);
-		v->setPath(nullptr);
-	}
-
-	src->setDist(0);
-
-	MutablePriorityQueue<Vertex> *queue = new MutablePriorityQueue<Vertex>;
-	queue->insert(src);
+void dijkstraWalking(Graph * graph, int source) {
+	dijkstraSearch<WalkingWeight>(graph, source);
+}
 
-	while (!queue->empty()) {
-		auto v = queue->extractMin();
-		v->setVisited(true);
+void dijkstraDriving(Graph * graph, int source) {
+	dijkstraSearch<DrivingWeight>(graph, source);
+}
 
-		for (auto e : v->getAdj()) {
-			auto u = e->getDest();
-			int walking = e->getWalking();
+// One-to-all searches used by the route planning functions. They all leave the same distances and parent edges in the
+// vertexes: a row of the precomputed all-pairs matrix when there is one, a cached tree of an earlier search from the
+// same source with the same closures, parallel delta-stepping on large maps, and Dijkstra otherwise. A search stopped
+// by the query deadline is not cached.
 
-			if (!u->isVisited() && v->getDist() + walking < u->getDist()) {
-				u->setDist(v->getDist() + walking);
-				u->setPath(e);
+static bool useDeltaStepping(Graph * graph) {
+	return graph->getNumVertex() >= DELTA_STEPPING_MIN_VERTICES && WorkerPool::shared().size() > 1;
+}
 
-				if (u->queueIndex == 0) {
-					queue->insert(u);
-				}
-				else {
-					queue->decreaseKey(u);
-				}
-			}
-		}
+static void searchDriving(Graph * graph, int source) {
+	if (allPairsSearch(graph, Metric::Driving, source) || cachedSearch(graph, Metric::Driving, source)) {
+		return;
 	}
 
-	delete queue;
+	if (useDeltaStepping(graph)) {
+		deltaSteppingDriving(graph, source);
+	}
+	else {
+		dijkstraDriving(graph, source);
+	}
+	if (!queryInterrupted()) {
+		cacheSearch(graph, Metric::Driving, source);
+	}
 }
 
-void dijkstraDriving(Graph * graph, int source) {
-	Vertex * src = graph->findVertexById(source);
-
-	if (!src) {
+static void searchWalking(Graph * graph, int source) {
+	if (allPairsSearch(graph, Metric::Walking, source) || cachedSearch(graph, Metric::Walking, source)) {
 		return;
 	}
 
-	for (auto v : graph->getVertexSet()) {
-		v->setDist(INT_MAX);
-		v->setVisited(false);
-		v->setPath(nullptr);
+	if (useDeltaStepping(graph)) {
+		deltaSteppingWalking(graph, source);
 	}
+	else {
+		dijkstraWalking(graph, source);
+	}
+	if (!queryInterrupted()) {
+		cacheSearch(graph, Metric::Walking, source);
+	}
+}
 
-	src->setDist(0);
-
-	MutablePriorityQueue<Vertex> *queue = new MutablePriorityQueue<Vertex>;
-	queue->insert(src);
-
-	while (!queue->empty()) {
-		auto v = queue->extractMin();
-		v->setVisited(true);
-
-		for (auto e : v->getAdj()) {
-			auto u = e->getDest();
-			int driving = e->getDriving();
-
-			if (!u->isVisited() && v->getDist() + driving < u->getDist()) {
-				u->setDist(v->getDist() + driving);
-				u->setPath(e);
+// Best driving route, without turn rules: read from the matrix when there is one, otherwise from a full (or cached)
+// search
 
-				if (u->queueIndex == 0) {
-					queue->insert(u);
-				}
-				else {
-					queue->decreaseKey(u);
-				}
-			}
-		}
+static Route exactDrivingRoute(Graph *graph, int source, int destination) {
+	Route matrixRoute;
+	if (allPairsRoute(graph, Metric::Driving, source, destination, matrixRoute)) {
+		return matrixRoute;
 	}
 
-	delete queue;
-}
-
-Route bestDrivingRoute(Graph *graph, int source, int destination) {
-	dijkstraDriving(graph, source);
+	searchDriving(graph, source);
 	Vertex * dest = graph->findVertexById(destination);
 
+	if (queryInterrupted()) {
+		return {{}, 0, ROUTE_TIMED_OUT};
+	}
+
 	if (dest->getDist() == INT_MAX) {
 		return {{}, 0, -1};
 	}
@@ -112,73 +104,120 @@ Route bestDrivingRoute(Graph *graph, int source, int destination) {
 	return {route, (int)route.size(), time};
 }
 
-Route bestAlternativeDrivingRoute(Graph* graph, Route &route) {
+Route bestDrivingRoute(Graph *graph, int source, int destination, double suboptimality) {
+	if (!mayReach(graph, Metric::Driving, source, destination)) {
+		return {{}, 0, -1};
+	}
+
+	// A matrix or a cached tree gives the exact route for less than any search
+	Route best;
+	if (suboptimality > 1 && graph->getLandmarks() != nullptr && graph->getMatrix(Metric::Driving) == nullptr
+		&& findCachedTree(graph, Metric::Driving, source) == nullptr) {
+		best = boundedDrivingRoute(graph, source, destination, suboptimality);
+	}
+	else {
+		best = exactDrivingRoute(graph, source, destination);
+	}
+
+	// Turn rules only ever add time or remove routes, so a route that meets none of them keeps its bound
+	TurnTable *turns = graph->getTurns();
+	if (best.time >= 0 && turns != nullptr && !turnFree(*turns, best)) {
+		return turnAwareRoute(graph, *turns, source, destination);
+	}
+	return best;
+}
+
+Route bestAlternativeDrivingRoute(Graph* graph, Route &route, double suboptimality) {
+	if (route.time < 0) {
+		return route;
+	}
+
+	// An articulation point between the endpoints is on every route, so closing the best one's locations cuts them off
+	if (!mayHaveAlternative(graph, route.r[0], route.r[route.length-1])) {
+		return {{}, 0, -1};
+	}
+
 	for (int i = 1; i < route.length - 1; i++) {
-		graph->removeVertex(route.r[i]);
+		graph->closeVertex(route.r[i]);
 	}
-	return bestDrivingRoute(graph, route.r[0], route.r[route.length-1]);
+	return bestDrivingRoute(graph, route.r[0], route.r[route.length-1], suboptimality);
 }
 
 // ------------------------------------ Final Solution Functions -------------------------------------------------- //
 
-// Helper function to remove vertexes, built because of reusability
+// Helper function to remove vertexes, built because of reusability. The vertexes are closed rather than
+// deleted, so graph->reopenAll() brings them back without reloading the map.
 
 void removeNodes(Graph* graph, const std::vector<int>& nodes) {
-	for (int i = 0; i < nodes.size(); i++) {
-		graph->removeVertex(nodes[i]);
-	}
+	TraceSpan span("removeNodes");
+	graph->closeVertices(nodes);
 }
 
 // Helper function to remove only the edges, not vertexes
 
 void removeSegments(Graph* graph, const std::vector<std::pair<int, int>>& edges) {
-	for (auto &p : edges) {
-		Vertex* v1 = graph->findVertexById(p.first);
-		Vertex* v2 = graph->findVertexById(p.second);
-
-		if (v1 && v2) {
-			v1->removeEdge(p.second);
-			v2->removeEdge(p.first);
-		}
-	}
+	TraceSpan span("removeSegments");
+	graph->closeSegments(edges);
 }
 
 // Independent Route Planning
 
-void independentRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out) {
-	Route route = bestDrivingRoute(graph, routePlan.source, routePlan.destination);
-	out << "BestDrivingRoute:"; printRoute(route, out);
-
-	route = bestAlternativeDrivingRoute(graph, route);
-	out << "BestAlternativeDrivingRoute:"; printRoute(route, out);
+static void independentRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	Route route = bestDrivingRoute(graph, routePlan.source, routePlan.destination, routePlan.suboptimality);
+	result.routes.push_back(route);
+	result.routes.push_back(bestAlternativeDrivingRoute(graph, route, routePlan.suboptimality));
 }
 
-// Restricted Route Planning without any Included Nodes
+// Restricted Route Planning without any Included Nodes. A customized driving overlay takes the avoid lists per query,
+// so only the cells holding them are searched below their overlay; its routes are exact.
 
-void restrictedRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out) {
-	Route route = bestDrivingRoute(graph, routePlan.source, routePlan.destination);
-	out << "RestrictedDrivingRoute:"; printRoute(route, out);
+static Route overlayDrivingRoute(Graph * graph, const OverlayGraph &overlay, const RoutePlan &routePlan) {
+	Route route = overlay.route(routePlan.source, routePlan.destination, routePlan.avoidNodes, routePlan.avoidSegments);
+
+	TurnTable *turns = graph->getTurns();
+	if (route.time >= 0 && turns != nullptr && !turnFree(*turns, route)) {
+		return turnAwareRoute(graph, *turns, routePlan.source, routePlan.destination);
+	}
+	return route;
+}
+
+static void restrictedRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	Route route = {{}, 0, -1};
+	if (mayReachAvoiding(graph, routePlan.source, routePlan.destination, routePlan.avoidNodes, routePlan.avoidSegments)) {
+		OverlayGraph *overlay = graph->getOverlay();
+		if (overlay != nullptr && overlay->isCustomized() && overlay->getMetric() == Metric::Driving) {
+			route = overlayDrivingRoute(graph, *overlay, routePlan);
+		}
+		else {
+			route = bestDrivingRoute(graph, routePlan.source, routePlan.destination, routePlan.suboptimality);
+		}
+	}
+	result.routes.push_back(route);
 }
 
-// Restricted Route Planning with the Included Node
+// Restricted Route Planning with the Included Nodes
 
-void restrictedRouteInclude(Graph * graph, const RoutePlan &routePlan, std::ostream& out) {
-	Route route1 = bestDrivingRoute(graph, routePlan.source, routePlan.includeNode);
-	Route route2 = bestDrivingRoute(graph, routePlan.includeNode, routePlan.destination);
-	mergeRoutes(route1, route2);
-	out << "RestrictedDrivingRoute:"; printRoute(route1, out);
+static void restrictedRouteInclude(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	result.routes.push_back(waypointRoute(graph, Metric::Driving, routePlan.source, routePlan.includeNodes,
+										  routePlan.destination, routePlan.includeBestOrder));
 }
 
 // Driving and Walking Route Planning
 
+
 bool computeWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan) {
 	bool hasParking = false;
 
 	for (auto v : graph->getVertexSet()) {
+		if (v->isClosed()) {
+			continue;
+		}
+
 		if (v->getParking()) {
 			hasParking = true;
 
-			if (v->getDist() <=routePlan.maxWalkTime) {
+			// Unreachable parking nodes keep an INT_MAX distance, which an unlimited walking time would accept
+			if (v->getDist() != INT_MAX && v->getDist() <= routePlan.maxWalkTime) {
 				Route route;
 
 				Edge * cur = v->getPath();
@@ -200,113 +239,540 @@ bool computeWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, con
 	return hasParking;
 }
 
+// Walking routes read from the parking index, when the graph has one that covers the plan: no closures (the index
+// does not know about them) and a maximum walking time within its radius. Returns false if the index cannot be used.
+
+static bool indexedWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan, bool &hasParking) {
+	ParkingIndex * index = graph->getParkingIndex();
+	Vertex * dest = graph->findVertexById(routePlan.destination);
+
+	if (index == nullptr || dest == nullptr || graph->hasClosures() || routePlan.maxWalkTime > index->getRadius()) {
+		return false;
+	}
+
+	hasParking = index->getNumParking() > 0;
+	for (auto &entry : index->walksTo(dest->getIndex())) {
+		if (entry.time <= routePlan.maxWalkTime) {
+			walkingRoutes.push_back(index->walkingRoute(entry.parking, dest->getIndex()));
+		}
+	}
+	return true;
+}
+
+// Walking routes read from the all-pairs matrix, one parking node at a time: only the routes within the maximum
+// walking time are followed back, so no row is copied into the vertices. Walking is symmetric, so the route from the
+// destination to a parking node is walked the other way. Returns false if the matrix cannot answer every parking node.
+
+static bool matrixWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan, bool &hasParking) {
+	std::vector<Route> routes;
+	hasParking = false;
+
+	for (auto v : graph->getVertexSet()) {
+		if (!v->getParking()) {
+			continue;
+		}
+		hasParking = true;
+
+		long time = allPairsDistance(graph, Metric::Walking, routePlan.destination, v->getId());
+		if (time == AllPairsMatrix::SATURATED) {
+			return false;
+		}
+		if (time == INT_MAX || time > routePlan.maxWalkTime) {
+			continue;
+		}
+
+		Route route;
+		if (!allPairsRoute(graph, Metric::Walking, routePlan.destination, v->getId(), route)) {
+			return false;
+		}
+		std::reverse(route.r.begin(), route.r.end());
+		routes.push_back(route);
+	}
+
+	walkingRoutes.insert(walkingRoutes.end(), routes.begin(), routes.end());
+	return true;
+}
+
+// Walking routes from every parking node within the maximum walking time, from the index, the matrix or with a
+// walking search
+
+static bool findWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan) {
+	bool hasParking;
+	if (indexedWalkingRoutes(graph, walkingRoutes, routePlan, hasParking)
+		|| matrixWalkingRoutes(graph, walkingRoutes, routePlan, hasParking)) {
+		return hasParking;
+	}
+
+	searchWalking(graph, routePlan.destination);
+	return computeWalkingRoutes(graph, walkingRoutes, routePlan);
+}
+
+// Driving route from the source to a parking node, read from the last driving search
+
+static Route drivingRouteTo(Vertex * parking, int source) {
+	Route drivingRoute;
+	drivingRoute.time = parking->getDist();
+	for (Edge * cur = parking->getPath(); cur != nullptr; cur = cur->getOrig()->getPath()) {
+		drivingRoute.r.push_back(cur->getDest()->getId());
+	}
+	drivingRoute.r.push_back(source);
+	std::reverse(drivingRoute.r.begin(), drivingRoute.r.end());
+	drivingRoute.length = drivingRoute.r.size();
+	return drivingRoute;
+}
+
+// With turn rules, the driving times of the search are only lower bounds: a driving route that makes a banned or
+// penalized turn is searched again with turnAwareRoute(). Parking nodes are checked by increasing lower bound of the
+// total time, until the bound goes past the best total checked, so only the few best ones pay for a search.
+
+static void turnCheckedDrivingWalking(Graph * graph, const TurnTable &turns, const std::vector<Route>& walkingRoutes,
+									  Route& bestDriving, Route& bestWalking, const RoutePlan& routePlan) {
+	std::vector<std::pair<long, const Route *>> candidates;
+	for (auto &walkingRoute : walkingRoutes) {
+		long drivingDistance = graph->findVertexById(walkingRoute.r[0])->getDist();
+		if (drivingDistance != INT_MAX) {
+			candidates.emplace_back(drivingDistance + walkingRoute.time, &walkingRoute);
+		}
+	}
+
+	// Equal totals go to the longer walk, as without turn rules
+	std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+		if (a.first != b.first) {
+			return a.first < b.first;
+		}
+		return a.second->time > b.second->time;
+	});
+
+	long bestTotal = (long)bestDriving.time + bestWalking.time;
+	for (auto &[bound, walkingRoute] : candidates) {
+		if (bound > bestTotal || queryInterrupted()) {
+			break;
+		}
+
+		int parking = walkingRoute->r[0];
+		Route drivingRoute = drivingRouteTo(graph->findVertexById(parking), routePlan.source);
+		if (!turnFree(turns, drivingRoute)) {
+			drivingRoute = turnAwareRoute(graph, turns, routePlan.source, parking);
+		}
+		if (drivingRoute.time < 0) {
+			continue;
+		}
+
+		long total = (long)drivingRoute.time + walkingRoute->time;
+		if (total < bestTotal || (total == bestTotal && bestWalking.time < walkingRoute->time)) {
+			bestTotal = total;
+			bestDriving = drivingRoute;
+			bestWalking = *walkingRoute;
+		}
+	}
+}
+
 // Helper function to find the best walking and driving routes
 
 void bestDrivingWalking(Graph * graph, const std::vector<Route>& walkingRoutes, Route& bestDriving, Route& bestWalking, const RoutePlan& routePlan) {
+	if (TurnTable * turns = graph->getTurns()) {
+		turnCheckedDrivingWalking(graph, *turns, walkingRoutes, bestDriving, bestWalking, routePlan);
+		return;
+	}
+
 	int curWalkingTime = 0;
 
 	for (auto &walkingRoute : walkingRoutes) {
-		int id = walkingRoute.r[0];
-		int drivingDistance = graph->findVertexById(id)->getDist();
-
-		if (drivingDistance + walkingRoute.time < bestDriving.time + bestWalking.time ||
-		(drivingDistance + walkingRoute.time == bestDriving.time + bestWalking.time && curWalkingTime < walkingRoute.time)) {
+		Vertex * parking = graph->findVertexById(walkingRoute.r[0]);
+		long drivingDistance = parking->getDist();
+		if (drivingDistance == INT_MAX) {
+			continue;
+		}
 
+		// Compared in long, so that the sums cannot overflow
+		long total = drivingDistance + walkingRoute.time;
+		long bestTotal = (long)bestDriving.time + bestWalking.time;
+		if (total < bestTotal || (total == bestTotal && curWalkingTime < walkingRoute.time)) {
 			curWalkingTime = walkingRoute.time;
-			Route drivingRoute;
+			bestDriving = drivingRouteTo(parking, routePlan.source);
+			bestWalking = walkingRoute;
+		}
+	}
+}
 
-			Edge * cur = graph->findVertexById(id)->getPath();
-			drivingRoute.time = graph->findVertexById(id)->getDist();
+// One driving and walking option: the walking routes from the parking nodes within the maximum walking time, and
+// the best driving route to one of them. Without any such pair of routes, both routes of the option have time -1.
 
-			while (cur != nullptr) {
-				drivingRoute.r.push_back(cur->getDest()->getId());
-				cur = cur->getOrig()->getPath();
-			}
-			drivingRoute.r.push_back(routePlan.source);
-			drivingRoute.length = drivingRoute.r.size();
+static MixedRoute drivingWalkingOption(Graph * graph, const RoutePlan &routePlan, bool &hasParking) {
+	std::vector<Route> walkingRoutes;
+	hasParking = findWalkingRoutes(graph, walkingRoutes, routePlan);
 
-			std::reverse(drivingRoute.r.begin(), drivingRoute.r.end());
+	if (!queryInterrupted() && !walkingRoutes.empty()) {
+		searchDriving(graph, routePlan.source);
+	}
+	if (queryInterrupted()) {
+		return {{{}, 0, ROUTE_TIMED_OUT}, {{}, 0, ROUTE_TIMED_OUT}};
+	}
+	if (walkingRoutes.empty()) {
+		return {{{}, 0, -1}, {{}, 0, -1}};
+	}
 
-			bestDriving = drivingRoute;
-			bestWalking = walkingRoute;
+	Route bestDriving = {{}, 0, INT_MAX / 2 - 1};
+	Route bestWalking = {{}, 0, INT_MAX / 2 - 1};
+
+	bestDrivingWalking(graph, walkingRoutes, bestDriving, bestWalking, routePlan);
+	if (queryInterrupted()) {
+		return {{{}, 0, ROUTE_TIMED_OUT}, {{}, 0, ROUTE_TIMED_OUT}};
+	}
+	if (bestWalking.r.empty()) {
+		return {{{}, 0, -1}, {{}, 0, -1}};
+	}
+	return {bestDriving, bestWalking};
+}
+
+// When no option fits the maximum walking time, the two best options without a limit are suggested instead, the
+// parking node of the first one being closed before looking for the second.
+
+static void drivingWalkingRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	MixedRoute option = drivingWalkingOption(graph, routePlan, result.hasParking);
+	if (option.driving.time == ROUTE_TIMED_OUT) {
+		result.timedOut = true;
+		return;
+	}
+	if (option.walking.time >= 0) {
+		result.options.push_back(option);
+		return;
+	}
+
+	result.withinMaxWalk = false;
+	if (!result.hasParking) {
+		return;
+	}
+
+	RoutePlan alternativeRoutePlan = routePlan;
+	alternativeRoutePlan.maxWalkTime = INT_MAX;
+	for (int i = 0; i < DRIVING_WALKING_SUGGESTIONS; i++) {
+		bool hasParking;
+		MixedRoute suggestion = drivingWalkingOption(graph, alternativeRoutePlan, hasParking);
+		if (!hasParking && suggestion.driving.time != ROUTE_TIMED_OUT) {
+			continue;
+		}
+
+		result.options.push_back(suggestion);
+		if (suggestion.walking.time >= 0) {
+			removeNodes(graph, {suggestion.walking.r[0]});
 		}
 	}
 }
 
-void drivingWalkingRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out, bool recursiveCall) {
- 	dijkstraWalking(graph, routePlan.destination);
+
+// Pareto Driving and Walking Route Planning
+
+// Only the walking leg has walking time, so each parking node gives a single candidate: the best driving route to
+// it and the best walking route from it. Any other route through the same parking node is slower and walks more,
+// so the Pareto front is the set of non-dominated parking candidates.
+
+std::vector<MixedRoute> paretoDrivingWalking(Graph * graph, const RoutePlan &routePlan) {
+	RoutePlan walkingPlan = routePlan;
+	if (walkingPlan.maxWalkTime < 0) {
+		walkingPlan.maxWalkTime = INT_MAX;
+	}
 
 	std::vector<Route> walkingRoutes;
-	bool hasParking = computeWalkingRoutes(graph, walkingRoutes, routePlan);
+	findWalkingRoutes(graph, walkingRoutes, walkingPlan);
 
-	if (walkingRoutes.size() == 0 && !recursiveCall) {
-		out << "DrivingRoute:none" << std::endl;
-		out << "ParkingNode:none" << std::endl;
-		out << "WalkingRoute:none" << std::endl;
-		out << "TotalTime:" << std::endl;
-		if (hasParking) {
-			out << "Message:No possible route with max. walking time of " << routePlan.maxWalkTime << " minutes." << std::endl;
+	searchDriving(graph, routePlan.source);
+
+	TurnTable * turns = graph->getTurns();
+	std::vector<MixedRoute> candidates;
+	for (auto &walkingRoute : walkingRoutes) {
+		Vertex * parking = graph->findVertexById(walkingRoute.r[0]);
+		if (parking->getDist() == INT_MAX) {
+			continue;
 		}
-		else {
-			out << "Message:Absence of parking spot." << std::endl;
+
+		// With turn rules, a driving route that makes a ruled turn is searched again, see turnCheckedDrivingWalking()
+		Route drivingRoute = drivingRouteTo(parking, routePlan.source);
+		if (turns != nullptr && !turnFree(*turns, drivingRoute)) {
+			drivingRoute = turnAwareRoute(graph, *turns, routePlan.source, parking->getId());
+			if (drivingRoute.time < 0) {
+				continue;
+			}
 		}
-		RoutePlan alternativeRoutePlan = routePlan;
-		alternativeRoutePlan.maxWalkTime = INT_MAX;
-		if (hasParking) {
-			out << std::endl << "Source:" << routePlan.source << std::endl;
-			out << "Destination:" << routePlan.destination << std::endl;
-			drivingWalkingRoute(graph, alternativeRoutePlan, out, true);
-			drivingWalkingRoute(graph, alternativeRoutePlan, out, true);
+
+		candidates.push_back({drivingRoute, walkingRoute});
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const MixedRoute &a, const MixedRoute &b) {
+		if (a.totalTime() != b.totalTime()) {
+			return a.totalTime() < b.totalTime();
+		}
+		return a.walking.time < b.walking.time;
+	});
+
+	// Scanning by total time, a candidate is on the front only if it walks strictly less than every faster one
+	std::vector<MixedRoute> front;
+	for (auto &candidate : candidates) {
+		if (front.empty() || candidate.walking.time < front.back().walking.time) {
+			front.push_back(candidate);
 		}
-		return;
 	}
+	return front;
+}
 
-	dijkstraDriving(graph, routePlan.source);
+static void drivingWalkingParetoRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	result.options = paretoDrivingWalking(graph, routePlan);
+	result.timedOut = queryInterrupted();
+}
 
-	Route bestDriving = {{}, 0, INT_MAX / 2 - 1};
-	Route bestWalking = {{}, 0, INT_MAX / 2 - 1};
 
-	bestDrivingWalking(graph, walkingRoutes, bestDriving, bestWalking, routePlan);
+// Isochrone Planning
+
+bool isIsochronePlan(const RoutePlan &routePlan) {
+	return routePlan.mode == "driving-isochrone" || routePlan.mode == "walking-isochrone";
+}
 
-	if (hasParking) {
-		out << "DrivingRoute:"; printRoute(bestDriving, out);
-		out << "ParkingNode:" << bestWalking.r[0] << std::endl;
-		out << "WalkingRoute:"; printRoute(bestWalking, out);
-		out << "TotalTime:" << bestWalking.time + bestDriving.time << std::endl;
+void printIsochroneResult(const RoutePlan &routePlan, const Isochrone &isochrone, std::ostream& out) {
+	out << "MaxTime:" << routePlan.maxTime << std::endl;
+	printIsochrone(isochrone, out);
+}
+
+static void isochroneRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	Metric metric = routePlan.mode == "driving-isochrone" ? Metric::Driving : Metric::Walking;
+	result.isochrone = isochrone(graph, metric, routePlan.source, routePlan.maxTime);
+	// A complete isochrone holds at least its origin, so one that finished before the deadline is kept
+	result.timedOut = result.isochrone.reachable.empty() && queryInterrupted();
+}
+
+
+// Accessibility Planning
+
+bool isAccessibilityPlan(const RoutePlan &routePlan) {
+	return routePlan.mode == "driving-accessibility";
+}
+
+Accessibility accessibilityOf(const std::vector<int> &dist, int source) {
+	Accessibility accessibility;
+	for (size_t v = 0; v < dist.size(); v++) {
+		if ((int)v == source || dist[v] == INT_MAX) {
+			continue;
+		}
+		accessibility.reachable++;
+		accessibility.totalTime += dist[v];
+		accessibility.farthestTime = std::max(accessibility.farthestTime, dist[v]);
+	}
+	return accessibility;
+}
+
+void printAccessibility(const Accessibility &accessibility, std::ostream& out) {
+	long average = accessibility.reachable == 0 ? 0
+		: (accessibility.totalTime + accessibility.reachable / 2) / accessibility.reachable;
+	out << "ReachableLocations:" << accessibility.reachable << std::endl;
+	out << "AverageTime:" << average << std::endl;
+	out << "FarthestTime:" << accessibility.farthestTime << std::endl;
+}
+
+static void accessibilityRoute(Graph * graph, const RoutePlan &routePlan, PlanResult &result) {
+	Vertex * src = graph->findVertexById(routePlan.source);
+	if (src == nullptr) {
+		return;
+	}
+
+	// A search stopped by the deadline leaves a partial tree, whose summary would look complete
+	searchDriving(graph, routePlan.source);
+	if (queryInterrupted()) {
+		result.timedOut = true;
+		return;
 	}
 
-	if (recursiveCall) {
-		removeNodes(graph, {bestWalking.r[0]});
+	std::vector<int> dist;
+	for (auto v : graph->getVertexSet()) {
+		dist.push_back(v->getDist());
 	}
+	result.accessibility = accessibilityOf(dist, src->getIndex());
 }
 
 
-// This function decides what to do according to the route plan that was chosen. Some behaviour, like printing the
-// source and destination or removing the nodes and segments is common to every plan there is, so it is done by this function.
+// Plans with no included or avoided locations get the best and the best alternative driving route
+
+static bool isIndependentPlan(const RoutePlan &routePlan) {
+	return routePlan.mode == "driving" && routePlan.includeNodes.empty() && routePlan.avoidNodes.empty()
+		&& routePlan.avoidSegments.empty();
+}
+
+// This function decides what to do according to the route plan that was chosen. Removing the nodes and segments is
+// common to every plan there is, so it is done by this function.
 
 // The avoidNodes and avoidSegments in RoutePlan is just an empty vector if those fields were empty in the input, so
 // nothing will be removed from the graph and the expected behaviour will be met.
 
-void resultMaker(Graph *graph, const RoutePlan &routePlan, std::ostream& out) {
-	out << "Source:" << routePlan.source << std::endl;
-	out << "Destination:" << routePlan.destination << std::endl;
+PlanResult planRoute(Graph *graph, const RoutePlan &routePlan) {
+	TraceSpan span("planRoute");
+	logQuery(routePlan);
+	QueryDeadline deadline(routePlan.deadline);
+	DeadlineScope scope(deadline);
 
+	PlanResult result;
 	removeNodes(graph, routePlan.avoidNodes);
 	removeSegments(graph, routePlan.avoidSegments);
 
-	if (routePlan.mode == "driving" && routePlan.includeNode < 0 && routePlan.avoidNodes.empty() && routePlan.avoidSegments.empty()) {
-		independentRoute(graph, routePlan, out);
+	if (isIsochronePlan(routePlan)) {
+		isochroneRoute(graph, routePlan, result);
 	}
-	else if (routePlan.mode == "driving" && (routePlan.includeNode >= 0 || !routePlan.avoidNodes.empty() || !routePlan.avoidSegments.empty())) {
-		if (routePlan.includeNode < 0) {
-			restrictedRoute(graph, routePlan, out);
+	else if (isAccessibilityPlan(routePlan)) {
+		accessibilityRoute(graph, routePlan, result);
+	}
+	else if (isIndependentPlan(routePlan)) {
+		independentRoute(graph, routePlan, result);
+	}
+	else if (routePlan.mode == "driving") {
+		if (routePlan.includeNodes.empty()) {
+			restrictedRoute(graph, routePlan, result);
+		}
+		else {
+			restrictedRouteInclude(graph, routePlan, result);
+		}
+	}
+	else if (routePlan.mode == "driving-walking") {
+		drivingWalkingRoute(graph, routePlan, result);
+	}
+	else if (routePlan.mode == "driving-walking-pareto") {
+		drivingWalkingParetoRoute(graph, routePlan, result);
+	}
+
+	for (const Route &route : result.routes) {
+		result.timedOut = result.timedOut || route.time == ROUTE_TIMED_OUT;
+	}
+	return result;
+}
+
+// Printing of the results, in the output file format
+
+static void printDrivingRoute(const char *label, const RoutePlan &routePlan, const Route &route, std::ostream& out) {
+	out << label; printRoute(route, out);
+	if (routePlan.suboptimality > 1) {
+		printBound(route, out);
+	}
+}
+
+static void printDrivingWalkingTimeout(std::ostream& out) {
+	out << "DrivingRoute:timeout" << std::endl;
+	out << "ParkingNode:none" << std::endl;
+	out << "WalkingRoute:timeout" << std::endl;
+	out << "TotalTime:" << std::endl;
+}
+
+static void printIsochroneTimeout(const RoutePlan &routePlan, std::ostream& out) {
+	out << "MaxTime:" << routePlan.maxTime << std::endl;
+	out << "ReachableLocations:timeout" << std::endl;
+}
+
+static void printAccessibilityTimeout(std::ostream& out) {
+	out << "ReachableLocations:timeout" << std::endl;
+	out << "AverageTime:" << std::endl;
+	out << "FarthestTime:" << std::endl;
+}
+
+static void printMixedRoute(const MixedRoute &option, std::ostream& out) {
+	if (option.driving.time == ROUTE_TIMED_OUT) {
+		printDrivingWalkingTimeout(out);
+		return;
+	}
+
+	out << "DrivingRoute:"; printRoute(option.driving, out);
+	if (option.walking.r.empty()) {
+		out << "ParkingNode:none" << std::endl;
+	}
+	else {
+		out << "ParkingNode:" << option.walking.r[0] << std::endl;
+	}
+	out << "WalkingRoute:"; printRoute(option.walking, out);
+	out << "TotalTime:";
+	if (option.walking.time >= 0) {
+		out << option.totalTime();
+	}
+	out << std::endl;
+}
+
+static void printDrivingWalking(const RoutePlan &routePlan, const PlanResult &result, std::ostream& out) {
+	if (result.timedOut) {
+		printDrivingWalkingTimeout(out);
+		return;
+	}
+
+	if (result.withinMaxWalk) {
+		for (const MixedRoute &option : result.options) {
+			printMixedRoute(option, out);
+		}
+		return;
+	}
+
+	out << "DrivingRoute:none" << std::endl;
+	out << "ParkingNode:none" << std::endl;
+	out << "WalkingRoute:none" << std::endl;
+	out << "TotalTime:" << std::endl;
+	if (result.hasParking) {
+		out << "Message:No possible route with max. walking time of " << routePlan.maxWalkTime << " minutes." << std::endl;
+		out << std::endl << "Source:" << routePlan.source << std::endl;
+		out << "Destination:" << routePlan.destination << std::endl;
+		for (const MixedRoute &option : result.options) {
+			printMixedRoute(option, out);
+		}
+	}
+	else {
+		out << "Message:Absence of parking spot." << std::endl;
+	}
+}
+
+static void printDrivingWalkingPareto(const PlanResult &result, std::ostream& out) {
+	if (result.timedOut) {
+		out << "ParetoRoutes:timeout" << std::endl;
+		return;
+	}
+
+	out << "ParetoRoutes:" << result.options.size() << std::endl;
+	for (size_t i = 0; i < result.options.size(); i++) {
+		out << "Option:" << i + 1 << std::endl;
+		printMixedRoute(result.options[i], out);
+	}
+}
+
+void printPlanResult(const RoutePlan &routePlan, const PlanResult &result, std::ostream& out) {
+	TraceSpan span("printPlanResult");
+	out << "Source:" << routePlan.source << std::endl;
+
+	if (isIsochronePlan(routePlan)) {
+		if (result.timedOut) {
+			printIsochroneTimeout(routePlan, out);
+		}
+		else {
+			printIsochroneResult(routePlan, result.isochrone, out);
+		}
+		return;
+	}
+
+	if (isAccessibilityPlan(routePlan)) {
+		if (result.timedOut) {
+			printAccessibilityTimeout(out);
 		}
 		else {
-			restrictedRouteInclude(graph, routePlan, out);
+			printAccessibility(result.accessibility, out);
 		}
+		return;
+	}
+
+	out << "Destination:" << routePlan.destination << std::endl;
+	if (isIndependentPlan(routePlan)) {
+		printDrivingRoute("BestDrivingRoute:", routePlan, result.routes[0], out);
+		printDrivingRoute("BestAlternativeDrivingRoute:", routePlan, result.routes[1], out);
+	}
+	else if (routePlan.mode == "driving") {
+		printDrivingRoute("RestrictedDrivingRoute:", routePlan, result.routes[0], out);
 	}
 	else if (routePlan.mode == "driving-walking") {
-		drivingWalkingRoute(graph, routePlan, out);
+		printDrivingWalking(routePlan, result, out);
+	}
+	else if (routePlan.mode == "driving-walking-pareto") {
+		printDrivingWalkingPareto(result, out);
 	}
 }
 
+void resultMaker(Graph *graph, const RoutePlan &routePlan, std::ostream& out) {
+	TraceSpan span("resultMaker");
+	printPlanResult(routePlan, planRoute(graph, routePlan), out);
+}
@@ -11,6 +11,7 @@
 #include "Graph.h"
 #include "route.h"
 #include "inputHandler.h"
+#include "isochrone.h"
 
 /**
  * @brief Computes the shortest walking paths using Dijkstra's algorithm.
@@ -38,32 +39,39 @@ void dijkstraWalking(Graph * graph, int source);
  * @brief Computes the best driving route from source to destination.
  *
  * This function calculates the best driving route between two nodes, based on Dijkstra's algorithm.
- * The time complexity is O((V + E) log V) due to Dijkstra's algorithm.
+ * The time complexity is O((V + E) log V) due to Dijkstra's algorithm. If the graph has component labels and they
+ * put the two nodes apart, the route is rejected in O(1) without any search.
+ *
+ * With a suboptimality factor above 1 and landmarks in the graph, the route comes from a weighted A* search
+ * (see boundedDrivingRoute()) and may be up to that factor longer, unless an exact answer is already at hand.
  *
  * @param graph The graph on which the route will be calculated.
  * @param source The source node ID.
  * @param destination The destination node ID.
- * @return A `Route` object containing the best route, including the path and total time.
+ * @param suboptimality The largest accepted ratio to the best time.
+ * @return A `Route` object containing the best route, including the path, total time and bound.
  */
-Route bestDrivingRoute(Graph *graph, int source, int destination);
+Route bestDrivingRoute(Graph *graph, int source, int destination, double suboptimality = 1);
 
 /**
  * @brief Computes the best alternative driving route by removing the primary path vertices.
  *
- * This function computes an alternative driving route by removing the vertices in the primary route.
+ * This function computes an alternative driving route by closing the vertices in the primary route.
  * The time complexity is O((V + E) log V) due to Dijkstra's algorithm.
  *
  * @param graph The graph on which the route will be calculated.
  * @param route The best driving route to be modified.
+ * @param suboptimality The largest accepted ratio to the best alternative time.
  * @return A `Route` object containing the alternative driving route.
  */
-Route bestAlternativeDrivingRoute(Graph *graph, Route &route);
+Route bestAlternativeDrivingRoute(Graph *graph, Route &route, double suboptimality = 1);
 
 /**
  * @brief Removes specified nodes from the graph.
  *
- * This function removes a list of nodes from the graph.
- * The complexity is O(N), where N is the number of nodes to be removed.
+ * This function closes a list of nodes in the graph, detaching all their edges. The nodes can be brought back
+ * with Graph::reopenAll().
+ * The complexity is O(N * D), where N is the number of nodes to be removed and D the maximum degree.
  *
  * @param graph The graph from which nodes will be removed.
  * @param nodes A vector of node IDs to be removed.
@@ -73,8 +81,9 @@ void removeNodes(Graph* graph, const std::vector<int>& nodes);
 /**
  * @brief Removes specified segments (edges) from the graph.
  *
- * This function removes a list of segments from the graph.
- * The complexity is O(E), where E is the number of edges to be removed.
+ * This function closes a list of segments in the graph, in both directions. The segments can be brought back
+ * with Graph::reopenAll().
+ * The complexity is O(E * D), where E is the number of edges to be removed and D the maximum degree.
  *
  * @param graph The graph from which edges will be removed.
  * @param edges A vector of pairs, each containing two node IDs representing an edge.
@@ -82,81 +91,160 @@ void removeNodes(Graph* graph, const std::vector<int>& nodes);
 void removeSegments(Graph* graph, const std::vector<std::pair<int, int>>& edges);
 
 /**
- * @brief Plans a route that does not involve any restricted areas or nodes.
+ * @brief Computes all walking routes for parking spots and the destination.
  *
- * This function computes both the best driving route and the best alternative driving route, printing the results.
+ * This function computes all walking routes from parking spots to the destination.
+ * The time complexity is O(V + E), since it iterates through all vertices and edges.
  *
  * @param graph The graph to be used for route calculation.
- * @param routePlan The route plan with source and destination.
- * @param out The output stream to which the results will be printed.
+ * @param walkingRoutes A vector to store the computed walking routes.
+ * @param routePlan The route plan that includes constraints.
+ * @return True if there are parking spots available, false otherwise.
  */
-void independentRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out);
+bool computeWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan);
 
 /**
- * @brief Plans a restricted route without considering any included nodes.
+ * @brief Finds the best combination of driving and walking routes.
  *
- * This function computes the best restricted driving route, printing the result.
+ * This function computes the best driving and walking routes from a set of available walking routes.
+ * The time complexity is O(W), where W is the number of walking routes considered. With turn rules, driving routes
+ * that make a banned or penalized turn are searched again with turnAwareRoute(), best candidates first.
  *
  * @param graph The graph to be used for route calculation.
- * @param routePlan The route plan with source and destination.
- * @param out The output stream to which the results will be printed.
+ * @param walkingRoutes A vector of walking routes to be considered.
+ * @param bestDriving The best driving route (output).
+ * @param bestWalking The best walking route (output).
+ * @param routePlan The route plan that includes constraints.
+ */
+void bestDrivingWalking(Graph * graph, const std::vector<Route>& walkingRoutes, Route& bestDriving, Route& bestWalking, const RoutePlan& routePlan);
+
+/**
+ * @struct MixedRoute
+ * @brief A driving route to a parking node followed by a walking route from it to the destination.
  */
-void restrictedRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out);
+struct MixedRoute {
+	Route driving;
+	Route walking;
+
+	int totalTime() const { return driving.time + walking.time; }
+};
 
 /**
- * @brief Plans a restricted route while including a specific node.
+ * @brief Computes the Pareto front of the driving and walking routes, by total time and walking time.
  *
- * This function computes the best restricted driving route by considering a specific node for inclusion.
+ * Each route on the front is faster than every route that walks less, so the front shows what each extra minute
+ * of walking saves. Uses one walking search from the destination and one driving search from the source; the time
+ * complexity is O((V + E) log V + P log P), where P is the number of parking nodes.
  *
  * @param graph The graph to be used for route calculation.
- * @param routePlan The route plan with source, destination, and the included node.
- * @param out The output stream to which the results will be printed.
+ * @param routePlan The route plan; a negative maxWalkTime means no walking limit.
+ * @return The front, by increasing total time (and therefore decreasing walking time).
  */
-void restrictedRouteInclude(Graph * graph, const RoutePlan &routePlan, std::ostream& out);
+std::vector<MixedRoute> paretoDrivingWalking(Graph * graph, const RoutePlan &routePlan);
 
 /**
- * @brief Computes all walking routes for parking spots and the destination.
+ * @brief Tells whether a route plan asks for an isochrone ("driving-isochrone" or "walking-isochrone" mode).
  *
- * This function computes all walking routes from parking spots to the destination.
- * The time complexity is O(V + E), since it iterates through all vertices and edges.
+ * @param routePlan The route plan.
+ * @return True for the isochrone modes.
+ */
+bool isIsochronePlan(const RoutePlan &routePlan);
+
+/**
+ * @brief Prints the result of an isochrone plan: the time limit and the reachable locations with their times.
  *
- * @param graph The graph to be used for route calculation.
- * @param walkingRoutes A vector to store the computed walking routes.
- * @param routePlan The route plan that includes constraints.
- * @return True if there are parking spots available, false otherwise.
+ * @param routePlan The route plan with the source and the time limit.
+ * @param isochrone The isochrone computed for the plan.
+ * @param out The output stream to which the results will be printed.
  */
-bool computeWalkingRoutes(Graph * graph, std::vector<Route> & walkingRoutes, const RoutePlan &routePlan);
+void printIsochroneResult(const RoutePlan &routePlan, const Isochrone &isochrone, std::ostream& out);
 
 /**
- * @brief Finds the best combination of driving and walking routes.
+ * @struct Accessibility
+ * @brief How many locations can be reached by car from a source, and how fast.
+ */
+struct Accessibility {
+	int reachable = 0;
+	long totalTime = 0;
+	int farthestTime = 0;
+};
+
+/**
+ * @brief Tells whether a route plan asks for a driving accessibility score ("driving-accessibility" mode).
  *
- * This function computes the best driving and walking routes from a set of available walking routes.
- * The time complexity is O(W), where W is the number of walking routes considered.
+ * @param routePlan The route plan.
+ * @return True for the accessibility mode.
+ */
+bool isAccessibilityPlan(const RoutePlan &routePlan);
+
+/**
+ * @brief Summarizes the driving times from a source.
  *
- * @param graph The graph to be used for route calculation.
- * @param walkingRoutes A vector of walking routes to be considered.
- * @param bestDriving The best driving route (output).
- * @param bestWalking The best walking route (output).
- * @param routePlan The route plan that includes constraints.
+ * @param dist The driving time to each location by dense index, INT_MAX if unreachable.
+ * @param source The dense index of the source, which is not counted.
+ * @return The number of other reachable locations, the sum of their times and the largest one.
  */
-void bestDrivingWalking(Graph * graph, const std::vector<Route>& walkingRoutes, Route& bestDriving, Route& bestWalking, const RoutePlan& routePlan);
+Accessibility accessibilityOf(const std::vector<int> &dist, int source);
 
 /**
- * @brief Computes both driving and walking routes based on the route plan.
+ * @brief Prints an accessibility score as `ReachableLocations:n`, `AverageTime:t` (rounded) and `FarthestTime:t`.
  *
- * This function computes a combination of driving and walking routes. If no viable solution is found, it recursively tries alternative routes.
+ * @param accessibility The score.
+ * @param out The output stream to which the results will be printed.
+ */
+void printAccessibility(const Accessibility &accessibility, std::ostream& out);
+
+/**
+ * @struct PlanResult
+ * @brief The structured result of a route plan, before any printing.
+ *
+ * Only the fields of the plan's mode are filled:
+ * - "driving": `routes` holds the best and the best alternative route, or the single restricted route (time -1 if
+ *   there is none) when the plan includes or avoids locations.
+ * - "driving-walking": `options` holds the best option, or the suggestions without a walking limit when
+ *   `withinMaxWalk` is false; `hasParking` tells whether the map has any parking node to walk from.
+ * - "driving-walking-pareto": `options` holds the Pareto front.
+ * - isochrone and accessibility modes: `isochrone` and `accessibility`.
+ *
+ * `timedOut` is set when the plan's deadline stopped the search; the routes cut short have time ROUTE_TIMED_OUT,
+ * and an isochrone or accessibility score cut short is left incomplete and printed as `timeout`.
+ */
+struct PlanResult {
+	std::vector<Route> routes;
+	std::vector<MixedRoute> options;
+	bool hasParking = false;
+	bool withinMaxWalk = true;
+	Isochrone isochrone = {-1, -1, {}};
+	Accessibility accessibility;
+	bool timedOut = false;
+};
+
+/**
+ * @brief Computes the result of a route plan, without any I/O.
+ *
+ * The avoided nodes and segments of the plan are closed in the graph and stay closed: call Graph::reopenAll()
+ * before the next plan (RoutingEngine::plan() does). The plan's deadline applies, and the plan is recorded in the
+ * query log if one is set.
  *
  * @param graph The graph to be used for route calculation.
- * @param routePlan The route plan that includes constraints.
+ * @param routePlan The route plan containing all constraints.
+ * @return The routes found for the plan's mode.
+ */
+PlanResult planRoute(Graph *graph, const RoutePlan &routePlan);
+
+/**
+ * @brief Prints the result of a route plan in the output file format, starting with its `Source:` line.
+ *
+ * @param routePlan The route plan the result was computed for.
+ * @param result The result returned by planRoute().
  * @param out The output stream to which the results will be printed.
- * @param recursiveCall Indicates whether the function is being called recursively.
  */
-void drivingWalkingRoute(Graph * graph, const RoutePlan &routePlan, std::ostream& out, bool recursiveCall = false);
+void printPlanResult(const RoutePlan &routePlan, const PlanResult &result, std::ostream& out);
 
 /**
  * @brief Creates the final results for route planning.
  *
- * This function outputs the final results for the route plan, including the source, destination, parking information, and selected routes.
+ * Computes the route plan with planRoute() and prints it with printPlanResult().
  *
  * @param graph The graph to be used for route calculation.
  * @param routePlan The route plan containing all constraints.
@@ -0,0 +1,331 @@
+#include "allPairs.h"
+#include "graphSnapshot.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+namespace {
+
+const char MAGIC[4] = {'A', 'P', 'M', '1'};
+
+template <typename T>
+void writeValue(std::ostream &out, const T &value) {
+	out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream &in, T &value) {
+	return (bool)in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeVector(std::ostream &out, const std::vector<T> &v) {
+	out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+}
+
+template <typename T>
+bool readVector(std::istream &in, std::vector<T> &v) {
+	return (bool)in.read(reinterpret_cast<char *>(v.data()), v.size() * sizeof(T));
+}
+
+// Dijkstra over the snapshot from one source, using buffers owned by the calling worker
+
+void snapshotDijkstra(const GraphSnapshot &snapshot, int source, std::vector<long> &dist, std::vector<int> &parent) {
+	using Entry = std::pair<long, int>;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+	std::fill(dist.begin(), dist.end(), INT_MAX);
+	std::fill(parent.begin(), parent.end(), -1);
+	dist[source] = 0;
+	queue.emplace(0, source);
+
+	while (!queue.empty()) {
+		auto [d, v] = queue.top();
+		queue.pop();
+		if (d != dist[v]) {
+			continue;
+		}
+
+		for (int i = snapshot.offsets[v]; i < snapshot.offsets[v + 1]; i++) {
+			int u = snapshot.targets[i];
+			long nd = d + snapshot.weights[i];
+			if (nd < dist[u]) {
+				dist[u] = nd;
+				parent[u] = v;
+				queue.emplace(nd, u);
+			}
+		}
+	}
+}
+
+}
+
+/********************** AllPairsMatrix  ****************************/
+
+AllPairsMatrix::AllPairsMatrix(int n, Metric metric, bool compact, bool withPaths): n(n), metric(metric), compact(compact) {
+	size_t cells = (size_t)n * n;
+	if (compact) {
+		dist16.assign(cells, UINT16_MAX);
+	}
+	else {
+		dist32.assign(cells, UINT32_MAX);
+	}
+	if (withPaths) {
+		parents.assign(cells, -1);
+	}
+}
+
+int AllPairsMatrix::size() const {
+	return n;
+}
+
+Metric AllPairsMatrix::getMetric() const {
+	return metric;
+}
+
+bool AllPairsMatrix::isCompact() const {
+	return compact;
+}
+
+bool AllPairsMatrix::hasPaths() const {
+	return !parents.empty();
+}
+
+// The largest value of the storage type means unreachable and the one below it means saturated
+
+long AllPairsMatrix::distance(int from, int to) const {
+	size_t cell = (size_t)from * n + to;
+	unsigned long value = compact ? dist16[cell] : dist32[cell];
+	unsigned long max = compact ? UINT16_MAX : UINT32_MAX;
+
+	if (value == max) {
+		return INT_MAX;
+	}
+	if (value == max - 1) {
+		return SATURATED;
+	}
+	return value;
+}
+
+int AllPairsMatrix::getParent(int from, int to) const {
+	return parents.empty() ? -1 : parents[(size_t)from * n + to];
+}
+
+void AllPairsMatrix::set(int from, int to, long dist, int parentIndex) {
+	size_t cell = (size_t)from * n + to;
+	unsigned long max = compact ? UINT16_MAX : UINT32_MAX;
+	unsigned long value = dist >= INT_MAX ? max : std::min((unsigned long)dist, max - 1);
+
+	if (compact) {
+		dist16[cell] = value;
+	}
+	else {
+		dist32[cell] = value;
+	}
+	if (!parents.empty()) {
+		parents[cell] = parentIndex;
+	}
+}
+
+void AllPairsMatrix::save(std::ostream &out, const Graph *graph) const {
+	out.write(MAGIC, sizeof(MAGIC));
+	writeValue<int32_t>(out, n);
+	writeValue<int32_t>(out, (int32_t)metric);
+	writeValue<int32_t>(out, compact);
+	writeValue<int32_t>(out, hasPaths());
+
+	for (auto v : graph->getVertexSet()) {
+		writeValue<int32_t>(out, v->getId());
+	}
+
+	if (compact) {
+		writeVector(out, dist16);
+	}
+	else {
+		writeVector(out, dist32);
+	}
+	writeVector(out, parents);
+}
+
+AllPairsMatrix *AllPairsMatrix::load(std::istream &in, const Graph *graph) {
+	char magic[sizeof(MAGIC)];
+	int32_t n, metric, compact, withPaths;
+
+	if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+		return nullptr;
+	}
+	if (!readValue(in, n) || !readValue(in, metric) || !readValue(in, compact) || !readValue(in, withPaths)) {
+		return nullptr;
+	}
+	if (n != graph->getNumVertex() || (metric != (int32_t)Metric::Driving && metric != (int32_t)Metric::Walking)) {
+		return nullptr;
+	}
+
+	for (auto v : graph->getVertexSet()) {
+		int32_t id;
+		if (!readValue(in, id) || id != v->getId()) {
+			return nullptr;
+		}
+	}
+
+	auto matrix = new AllPairsMatrix(n, (Metric)metric, compact, withPaths);
+	bool ok = compact ? readVector(in, matrix->dist16) : readVector(in, matrix->dist32);
+	if (!ok || !readVector(in, matrix->parents)) {
+		delete matrix;
+		return nullptr;
+	}
+	return matrix;
+}
+
+/********************** Precomputation  ****************************/
+
+AllPairsMatrix *computeAllPairs(const Graph *graph, Metric metric, bool compact, bool withPaths, WorkerPool &pool) {
+	GraphSnapshot snapshot = makeSnapshot(graph, metric);
+	int n = snapshot.numVertex();
+	auto matrix = new AllPairsMatrix(n, metric, compact, withPaths);
+
+	std::vector<std::vector<long>> dist(pool.size(), std::vector<long>(n));
+	std::vector<std::vector<int>> parents(pool.size(), std::vector<int>(n));
+
+	// Each row is written by a single worker, so no synchronisation is needed on the matrix
+	pool.run(n, [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t s = begin; s < end; s++) {
+			snapshotDijkstra(snapshot, s, dist[worker], parents[worker]);
+			for (int t = 0; t < n; t++) {
+				matrix->set(s, t, dist[worker][t], parents[worker][t]);
+			}
+		}
+	}, 1);
+
+	return matrix;
+}
+
+bool precomputeAllPairs(Graph *graph, bool compact) {
+	if (graph->hasClosures()) {
+		return false;
+	}
+
+	graph->setMatrix(Metric::Driving, computeAllPairs(graph, Metric::Driving, compact));
+	graph->setMatrix(Metric::Walking, computeAllPairs(graph, Metric::Walking, compact));
+	return true;
+}
+
+bool saveAllPairs(const Graph *graph, const std::string &filename) {
+	AllPairsMatrix *driving = graph->getMatrix(Metric::Driving);
+	AllPairsMatrix *walking = graph->getMatrix(Metric::Walking);
+
+	if (driving == nullptr || walking == nullptr) {
+		return false;
+	}
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Error: Could not open file: " << filename << std::endl;
+		return false;
+	}
+
+	driving->save(file, graph);
+	walking->save(file, graph);
+	return (bool)file;
+}
+
+bool loadAllPairs(Graph *graph, const std::string &filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	AllPairsMatrix *driving = AllPairsMatrix::load(file, graph);
+	AllPairsMatrix *walking = driving ? AllPairsMatrix::load(file, graph) : nullptr;
+
+	if (driving == nullptr || walking == nullptr || driving->getMetric() != Metric::Driving ||
+		walking->getMetric() != Metric::Walking) {
+		delete driving;
+		delete walking;
+		return false;
+	}
+
+	graph->setMatrix(Metric::Driving, driving);
+	graph->setMatrix(Metric::Walking, walking);
+	return true;
+}
+
+/********************** Queries  ****************************/
+
+bool allPairsSearch(Graph *graph, Metric metric, int source) {
+	AllPairsMatrix *matrix = graph->getMatrix(metric);
+	Vertex *src = graph->findVertexById(source);
+
+	if (matrix == nullptr || !matrix->hasPaths() || graph->hasClosures() || src == nullptr) {
+		return false;
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int s = src->getIndex();
+
+	for (size_t t = 0; t < vertices.size(); t++) {
+		if (matrix->distance(s, t) == AllPairsMatrix::SATURATED) {
+			return false;
+		}
+	}
+
+	for (size_t t = 0; t < vertices.size(); t++) {
+		Vertex *v = vertices[t];
+		long dist = matrix->distance(s, t);
+		int p = matrix->getParent(s, t);
+		Edge *path = nullptr;
+
+		// The matrix keeps the parent vertex, the parent edge is the cheapest one from it to v
+		if (p >= 0) {
+			for (auto e : vertices[p]->getAdj()) {
+				if (e->getDest() == v && (path == nullptr || e->getWeight(metric) < path->getWeight(metric))) {
+					path = e;
+				}
+			}
+		}
+
+		v->setDist(dist);
+		v->setVisited(dist != INT_MAX);
+		v->setPath(path);
+	}
+
+	return true;
+}
+
+long allPairsDistance(const Graph *graph, Metric metric, int source, int destination) {
+	AllPairsMatrix *matrix = graph->getMatrix(metric);
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+
+	if (matrix == nullptr || graph->hasClosures() || src == nullptr || dest == nullptr) {
+		return AllPairsMatrix::SATURATED;
+	}
+	return matrix->distance(src->getIndex(), dest->getIndex());
+}
+
+bool allPairsRoute(const Graph *graph, Metric metric, int source, int destination, Route &route) {
+	AllPairsMatrix *matrix = graph->getMatrix(metric);
+	long dist = allPairsDistance(graph, metric, source, destination);
+
+	if (dist == AllPairsMatrix::SATURATED || !matrix->hasPaths()) {
+		return false;
+	}
+	if (dist == INT_MAX) {
+		route = {{}, 0, -1};
+		return true;
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int s = graph->findVertexById(source)->getIndex();
+	std::vector<int> path;
+	for (int v = graph->findVertexById(destination)->getIndex(); v != s; v = matrix->getParent(s, v)) {
+		path.push_back(vertices[v]->getId());
+	}
+	path.push_back(source);
+	std::reverse(path.begin(), path.end());
+
+	route = {path, (int)path.size(), (int)dist};
+	return true;
+}
@@ -0,0 +1,157 @@
+/**
+* @file allPairs.h
+ * @brief Precomputed all-pairs distance and path matrices for small and medium maps.
+ *
+ * For maps of up to a few thousand locations, the driving and walking distances between every pair of
+ * locations can be computed once (one Dijkstra per source, run in parallel) and kept in the graph.
+ * The one-to-all searches of the route planner then become a copy of a matrix row, and point-to-point
+ * queries a lookup and a walk back along the parents.
+ */
+
+#ifndef ALLPAIRS_H
+#define ALLPAIRS_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+#include "workerPool.h"
+
+/**
+ * @brief Distances and shortest path parents between every pair of vertices, for one metric.
+ *
+ * Rows are indexed by the dense index of the source and columns by the dense index of the target.
+ * Distances are stored with saturating unsigned integers of 32 bits, or 16 bits in compact mode: values
+ * that do not fit are stored as saturated, and such entries have to be answered by a regular search.
+ */
+class AllPairsMatrix {
+public:
+	/**
+	 * @brief Value returned by distance() for an entry that did not fit in the storage.
+	 */
+	static const long SATURATED = -1;
+
+	AllPairsMatrix(int n, Metric metric, bool compact, bool withPaths);
+
+	int size() const;
+	Metric getMetric() const;
+	bool isCompact() const;
+	bool hasPaths() const;
+
+	/**
+	 * @brief Returns the distance between two vertices, INT_MAX if unreachable or SATURATED.
+	 */
+	long distance(int from, int to) const;
+
+	/**
+	 * @brief Returns the index of the vertex before `to` on the shortest path from `from`, or -1.
+	 */
+	int getParent(int from, int to) const;
+
+	void set(int from, int to, long dist, int parentIndex);
+
+	/**
+	 * @brief Writes the matrix in binary form, tagged with the vertex ids of the graph.
+	 */
+	void save(std::ostream &out, const Graph *graph) const;
+
+	/**
+	 * @brief Reads a matrix written by save().
+	 *
+	 * @return The matrix, or nullptr if the data is invalid or was computed for a different graph.
+	 */
+	static AllPairsMatrix *load(std::istream &in, const Graph *graph);
+
+private:
+	int n;
+	Metric metric;
+	bool compact;
+	std::vector<uint16_t> dist16;
+	std::vector<uint32_t> dist32;
+	std::vector<int32_t> parents;
+};
+
+/**
+ * @brief Computes the all-pairs matrix of a graph for one metric.
+ *
+ * Runs one Dijkstra per source over a snapshot of the graph, spread over the pool threads.
+ * The time complexity is O(V (V + E) log V) and the memory O(V^2).
+ *
+ * @param graph The graph, which must have no pending closures.
+ * @param metric The weight to use.
+ * @param compact If true, distances are stored in 16 bits.
+ * @param withPaths If false, only distances are stored.
+ * @param pool The threads used to run the searches.
+ * @return The new matrix.
+ */
+AllPairsMatrix *computeAllPairs(const Graph *graph, Metric metric, bool compact = false, bool withPaths = true,
+								WorkerPool &pool = WorkerPool::shared());
+
+/**
+ * @brief Computes the driving and walking matrices and stores them in the graph.
+ *
+ * @param graph The graph.
+ * @param compact If true, distances are stored in 16 bits.
+ * @return False if the graph has pending closures, in which case nothing is computed.
+ */
+bool precomputeAllPairs(Graph *graph, bool compact = false);
+
+/**
+ * @brief Saves the driving and walking matrices of the graph to a binary file.
+ *
+ * @return False if the graph has no matrices or the file cannot be written.
+ */
+bool saveAllPairs(const Graph *graph, const std::string &filename);
+
+/**
+ * @brief Loads the driving and walking matrices of the graph from a file written by saveAllPairs().
+ *
+ * @return False if the file cannot be read or belongs to a different map.
+ */
+bool loadAllPairs(Graph *graph, const std::string &filename);
+
+/**
+ * @brief Fills the vertices with a row of the precomputed matrix, as a one-to-all search would.
+ *
+ * Sets `dist`, `visited` and `path` of every vertex exactly like dijkstraDriving/dijkstraWalking, in O(V + E).
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source node.
+ * @return False if there is no usable matrix (none computed, pending closures or saturated entries in the
+ *         row), in which case the vertices are left untouched.
+ */
+bool allPairsSearch(Graph *graph, Metric metric, int source);
+
+/**
+ * @brief Reads the best time between two locations from the precomputed matrix, in O(1).
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source node.
+ * @param destination The ID of the destination node.
+ * @return The time, INT_MAX if the destination is unreachable, or AllPairsMatrix::SATURATED if the matrix cannot
+ *         answer (none computed, pending closures, an unknown location or a saturated entry).
+ */
+long allPairsDistance(const Graph *graph, Metric metric, int source, int destination);
+
+/**
+ * @brief Reads the best route between two locations from the precomputed matrix, as a point-to-point search would.
+ *
+ * The time is the matrix entry and the route follows the stored parents back from the destination, so the cost is
+ * the length of the route rather than the O(V + E) of allPairsSearch(). The locations are those of the route that
+ * allPairsSearch() leaves in the vertices.
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source node.
+ * @param destination The ID of the destination node.
+ * @param route Set to the route, with time -1 if there is none.
+ * @return False if the matrix cannot answer (see allPairsDistance(), or no parents were stored), in which case
+ *         route is left untouched.
+ */
+bool allPairsRoute(const Graph *graph, Metric metric, int source, int destination, Route &route);
+
+#endif //ALLPAIRS_H
@@ -0,0 +1,152 @@
+#include "batch.h"
+#include "algorithms.h"
+#include "treeCache.h"
+#include "phast.h"
+#include "trace.h"
+#include "queryLog.h"
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+namespace {
+
+// Trees kept by the cache a batch uses when the graph has none; a group only needs its own
+const int BATCH_CACHE_TREES = 16;
+
+// Fewest accessibility plans worth building a hierarchy for: on the maps used here it takes about as long to
+// build as 500 one-to-all Dijkstra searches, after which a PHAST sweep costs a tenth of one per source
+const size_t PHAST_MIN_PLANS = 512;
+const size_t PHAST_BLOCK_PLANS = 1024;
+
+using AvoidSignature = std::pair<std::vector<int>, std::vector<std::pair<int, int>>>;
+
+// The avoid lists as a set: sorted, without repetitions, and with each segment's endpoints in increasing order
+
+AvoidSignature avoidSignature(const RoutePlan &plan) {
+	AvoidSignature signature = {plan.avoidNodes, {}};
+	for (auto &[id1, id2] : plan.avoidSegments) {
+		signature.second.emplace_back(std::min(id1, id2), std::max(id1, id2));
+	}
+
+	std::sort(signature.first.begin(), signature.first.end());
+	signature.first.erase(std::unique(signature.first.begin(), signature.first.end()), signature.first.end());
+	std::sort(signature.second.begin(), signature.second.end());
+	signature.second.erase(std::unique(signature.second.begin(), signature.second.end()), signature.second.end());
+	return signature;
+}
+
+}
+
+std::vector<size_t> scheduleBatch(const std::vector<RoutePlan> &routePlans) {
+	std::vector<std::tuple<AvoidSignature, int, int>> keys;
+	for (const RoutePlan &plan : routePlans) {
+		keys.emplace_back(avoidSignature(plan), plan.source, plan.destination);
+	}
+
+	std::vector<size_t> order(routePlans.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return keys[a] < keys[b];
+	});
+	return order;
+}
+
+void runBatch(Graph *graph, const std::vector<RoutePlan> &routePlans, std::ostream &out) {
+	std::vector<std::string> results(routePlans.size());
+	std::vector<bool> isPrecomputed(routePlans.size(), false);
+
+	// Unrestricted isochrone plans are grouped by metric and time limit, one parallel call per group
+	std::map<std::pair<std::string, int>, std::vector<size_t>> groups;
+	for (size_t i = 0; i < routePlans.size(); i++) {
+		const RoutePlan &plan = routePlans[i];
+		if (isIsochronePlan(plan) && plan.avoidNodes.empty() && plan.avoidSegments.empty()) {
+			groups[{plan.mode, plan.maxTime}].push_back(i);
+		}
+	}
+
+	for (auto &[key, plans] : groups) {
+		TraceSpan span("isochroneGroup");
+		Metric metric = key.first == "driving-isochrone" ? Metric::Driving : Metric::Walking;
+		std::vector<int> origins;
+		for (size_t i : plans) {
+			origins.push_back(routePlans[i].source);
+		}
+
+		std::vector<Isochrone> isochroneResults = isochrones(graph, metric, origins, key.second);
+		for (size_t k = 0; k < plans.size(); k++) {
+			std::ostringstream result;
+			result << "Source:" << routePlans[plans[k]].source << std::endl;
+			printIsochroneResult(routePlans[plans[k]], isochroneResults[k], result);
+			results[plans[k]] = result.str();
+			isPrecomputed[plans[k]] = true;
+			logQuery(routePlans[plans[k]]);
+		}
+	}
+
+	// Unrestricted accessibility plans share one hierarchy and are swept PHAST_LANES sources at a time
+	std::vector<size_t> analytics;
+	for (size_t i = 0; i < routePlans.size(); i++) {
+		const RoutePlan &plan = routePlans[i];
+		if (isAccessibilityPlan(plan) && plan.avoidNodes.empty() && plan.avoidSegments.empty()) {
+			analytics.push_back(i);
+		}
+	}
+
+	if (analytics.size() >= PHAST_MIN_PLANS) {
+		TraceSpan span("phastAccessibility");
+		PhastEngine engine(graph, Metric::Driving);
+
+		// Blocks bound the memory taken by the distance arrays
+		for (size_t first = 0; first < analytics.size(); first += PHAST_BLOCK_PLANS) {
+			size_t last = std::min(analytics.size(), first + PHAST_BLOCK_PLANS);
+			std::vector<int> sources;
+			for (size_t k = first; k < last; k++) {
+				sources.push_back(routePlans[analytics[k]].source);
+			}
+
+			std::vector<std::vector<int>> dist = engine.distances(sources);
+			for (size_t k = first; k < last; k++) {
+				size_t i = analytics[k];
+				Vertex *src = graph->findVertexById(routePlans[i].source);
+				std::ostringstream result;
+				result << "Source:" << routePlans[i].source << std::endl;
+				printAccessibility(src == nullptr ? Accessibility() : accessibilityOf(dist[k - first], src->getIndex()),
+								   result);
+				results[i] = result.str();
+				isPrecomputed[i] = true;
+				logQuery(routePlans[i]);
+			}
+		}
+	}
+
+	bool temporaryCache = graph->getTreeCache() == nullptr;
+	if (temporaryCache) {
+		enableTreeCache(graph, BATCH_CACHE_TREES * graph->getNumVertex() * (sizeof(long) + sizeof(Edge *)));
+	}
+
+	for (size_t i : scheduleBatch(routePlans)) {
+		if (isPrecomputed[i]) {
+			continue;
+		}
+
+		std::ostringstream result;
+		resultMaker(graph, routePlans[i], result);
+		graph->reopenAll();
+		results[i] = result.str();
+	}
+
+	if (temporaryCache) {
+		graph->setTreeCache(nullptr);
+	}
+
+	TraceSpan span("writeResults");
+	for (size_t i = 0; i < results.size(); i++) {
+		if (i > 0) {
+			out << std::endl;
+		}
+		out << results[i];
+	}
+}
@@ -0,0 +1,41 @@
+/**
+* @file batch.h
+ * @brief Batch mode: runs every route plan of a batch input file against the same graph.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <iostream>
+#include <vector>
+#include "Graph.h"
+#include "inputHandler.h"
+
+/**
+ * @brief Orders the plans of a batch so that plans sharing searches run one after another.
+ *
+ * Plans are grouped by avoid lists (taken as sets), then by source, then by destination; ties keep the input
+ * order. Within a group the closures are the same, so every plan after the first reuses the driving tree of the
+ * source (and plans with the same destination the walking tree) from the shortest path tree cache.
+ *
+ * @param routePlans The route plans, in input order.
+ * @return The indices of the plans, in the order to run them.
+ */
+std::vector<size_t> scheduleBatch(const std::vector<RoutePlan> &routePlans);
+
+/**
+ * @brief Runs a batch of route plans and prints their results in order, separated by blank lines.
+ *
+ * Each plan sees the graph as loaded: the closures made by a plan are reopened before the next one.
+ * Isochrone plans without avoided nodes or segments only read the graph, so they are all computed up front,
+ * in parallel; so are driving accessibility plans without avoided nodes or segments, with PHAST sweeps, when there
+ * are enough of them to pay for the hierarchy. The other plans run in the order given by scheduleBatch(), with a small shortest path tree cache
+ * if the graph has none. Results are kept until the whole batch is done and printed in input order.
+ *
+ * @param graph The graph to be used for route calculation.
+ * @param routePlans The route plans, in input order.
+ * @param out The output stream to which the results will be printed.
+ */
+void runBatch(Graph *graph, const std::vector<RoutePlan> &routePlans, std::ostream &out);
+
+#endif //BATCH_H
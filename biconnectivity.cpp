@@ -0,0 +1,390 @@
+#include "biconnectivity.h"
+#include <algorithm>
+#include <climits>
+#include <unordered_set>
+
+BiconnectivityIndex::BiconnectivityIndex(const Graph *graph) : graph(graph) {
+	decompose();
+	buildBlockCutTree();
+	buildBridgeTree();
+}
+
+/*
+ * Iterative form of Tarjan's search, since the recursive one can overflow the stack on large maps. A vertex's low-link
+ * is the smallest discovery number reachable from its subtree through one back edge; the edge to the parent is skipped
+ * by identity (through its reverse), so parallel segments still count as cycles. When a child's low-link does not go
+ * above its parent, the vertices pushed since the child, plus the parent, form a block; when it stays below, the
+ * edge to the child is a bridge.
+ */
+
+void BiconnectivityIndex::decompose() {
+	int n = graph->getNumVertex();
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+
+	cut.assign(n, false);
+	blockOf.assign(n, -1);
+	for (auto v : vertices) {
+		v->setNum(-1);
+		v->setLow(-1);
+	}
+
+	struct Frame {
+		Vertex *v;
+		Edge *parent;
+		size_t next;
+	};
+
+	std::vector<Frame> frames;
+	std::vector<Vertex *> stack;
+	int counter = 0;
+
+	for (auto root : vertices) {
+		if (root->getNum() != -1 || root->isClosed()) {
+			continue;
+		}
+
+		root->setNum(counter);
+		root->setLow(counter++);
+		frames.push_back({root, nullptr, 0});
+		stack.push_back(root);
+		int rootChildren = 0;
+
+		while (!frames.empty()) {
+			Frame &frame = frames.back();
+			Vertex *v = frame.v;
+
+			if (frame.next < v->getAdj().size()) {
+				Edge *e = v->getAdj()[frame.next++];
+				Vertex *u = e->getDest();
+				if (e->getDriving() == INT_MAX || (frame.parent != nullptr && e == frame.parent->getReverse())) {
+					continue;
+				}
+
+				if (u->getNum() == -1) {
+					if (frames.size() == 1) {
+						rootChildren++;
+					}
+					u->setNum(counter);
+					u->setLow(counter++);
+					stack.push_back(u);
+					frames.push_back({u, e, 0});
+				}
+				else {
+					v->setLow(std::min(v->getLow(), u->getNum()));
+				}
+				continue;
+			}
+
+			Edge *parentEdge = frame.parent;
+			frames.pop_back();
+			if (frames.empty()) {
+				break;
+			}
+
+			Vertex *p = frames.back().v;
+			p->setLow(std::min(p->getLow(), v->getLow()));
+
+			if (v->getLow() > p->getNum()) {
+				bridges.push_back(parentEdge);
+			}
+			if (v->getLow() >= p->getNum()) {
+				if (p != root) {
+					cut[p->getIndex()] = true;
+				}
+
+				std::vector<int> block;
+				Vertex *w;
+				do {
+					w = stack.back();
+					stack.pop_back();
+					block.push_back(w->getIndex());
+				} while (w != v);
+				block.push_back(p->getIndex());
+				blocks.push_back(std::move(block));
+			}
+		}
+
+		stack.pop_back();
+		cut[root->getIndex()] = rootChildren > 1;
+		if (rootChildren == 0) {
+			blocks.push_back({root->getIndex()});
+		}
+	}
+
+	for (size_t b = 0; b < blocks.size(); b++) {
+		for (int v : blocks[b]) {
+			blockOf[v] = b;
+		}
+	}
+}
+
+// Blocks are nodes 0 to B - 1 and articulation points nodes B onwards, each joined to the blocks it belongs to
+
+void BiconnectivityIndex::buildBlockCutTree() {
+	int n = graph->getNumVertex();
+	int numBlocks = blocks.size();
+
+	cutNode.assign(n, -1);
+	for (int v = 0; v < n; v++) {
+		if (cut[v]) {
+			cutNode[v] = numBlocks + numCuts++;
+		}
+	}
+
+	std::vector<std::vector<int>> adj(numBlocks + numCuts);
+	std::vector<int> nodeWeight(numBlocks + numCuts, 0);
+	for (int b = 0; b < numBlocks; b++) {
+		for (int v : blocks[b]) {
+			if (cut[v]) {
+				adj[b].push_back(cutNode[v]);
+				adj[cutNode[v]].push_back(b);
+				nodeWeight[cutNode[v]] = 1;
+			}
+		}
+	}
+
+	blockCut.build(adj, nodeWeight);
+}
+
+// Pieces are the components left once the bridges are removed; the bridges join them into a forest
+
+void BiconnectivityIndex::buildBridgeTree() {
+	int n = graph->getNumVertex();
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+
+	std::unordered_set<const Edge *> isBridge;
+	for (auto e : bridges) {
+		isBridge.insert(e);
+		isBridge.insert(e->getReverse());
+	}
+
+	piece.assign(n, -1);
+	int numPieces = 0;
+	std::vector<int> stack;
+
+	for (int s = 0; s < n; s++) {
+		if (piece[s] != -1 || blockOf[s] == -1) {
+			continue;
+		}
+
+		piece[s] = numPieces;
+		stack.push_back(s);
+		while (!stack.empty()) {
+			int v = stack.back();
+			stack.pop_back();
+			for (auto e : vertices[v]->getAdj()) {
+				int u = e->getDest()->getIndex();
+				if (e->getDriving() != INT_MAX && piece[u] == -1 && !isBridge.count(e)) {
+					piece[u] = numPieces;
+					stack.push_back(u);
+				}
+			}
+		}
+		numPieces++;
+	}
+
+	std::vector<std::vector<int>> adj(numPieces);
+	for (auto e : bridges) {
+		int a = piece[e->getOrig()->getIndex()], b = piece[e->getDest()->getIndex()];
+		adj[a].push_back(b);
+		adj[b].push_back(a);
+	}
+	bridgeTree.build(adj, std::vector<int>(numPieces, 0));
+
+	bridgeTo.assign(numPieces, {-1, -1});
+	for (auto e : bridges) {
+		int a = e->getOrig()->getIndex(), b = e->getDest()->getIndex();
+		int child = bridgeTree.depth[piece[a]] > bridgeTree.depth[piece[b]] ? piece[a] : piece[b];
+		bridgeTo[child] = {a, b};
+	}
+}
+
+int BiconnectivityIndex::indexOf(int id) const {
+	Vertex *v = graph->findVertexById(id);
+	return v != nullptr ? v->getIndex() : -1;
+}
+
+int BiconnectivityIndex::blockNode(int v) const {
+	return cut[v] ? cutNode[v] : blockOf[v];
+}
+
+bool BiconnectivityIndex::isArticulationPoint(int id) const {
+	int v = indexOf(id);
+	return v != -1 && cut[v];
+}
+
+bool BiconnectivityIndex::isBridge(int id1, int id2) const {
+	int u = indexOf(id1), v = indexOf(id2);
+	if (u == -1 || v == -1 || piece[u] == -1 || piece[v] == -1 || piece[u] == piece[v]) {
+		return false;
+	}
+
+	// Two pieces are joined by at most one segment, which then is the bridge between them
+	int child = bridgeTree.depth[piece[u]] > bridgeTree.depth[piece[v]] ? piece[u] : piece[v];
+	int parent = child == piece[u] ? piece[v] : piece[u];
+	return bridgeTree.up[0][child] == parent && (bridgeTo[child] == std::make_pair(u, v) ||
+												 bridgeTo[child] == std::make_pair(v, u));
+}
+
+int BiconnectivityIndex::getNumArticulationPoints() const {
+	return numCuts;
+}
+
+int BiconnectivityIndex::getNumBridges() const {
+	return bridges.size();
+}
+
+bool BiconnectivityIndex::hasDisjointAlternative(int source, int destination) const {
+	int s = indexOf(source), t = indexOf(destination);
+	if (s == -1 || t == -1 || blockOf[s] == -1 || blockOf[t] == -1) {
+		return false;
+	}
+
+	int a = blockNode(s), b = blockNode(t);
+	if (blockCut.tree[a] != blockCut.tree[b]) {
+		return false;
+	}
+
+	// The endpoints themselves may be articulation points, but they do not count
+	return blockCut.weightOnPath(a, b) - cut[s] - cut[t] == 0 || s == t;
+}
+
+bool BiconnectivityIndex::disconnects(int source, int destination, const std::vector<int> &avoidNodes,
+									  const std::vector<std::pair<int, int>> &avoidSegments) const {
+	int s = indexOf(source), t = indexOf(destination);
+	if (s == -1 || t == -1 || blockOf[s] == -1 || blockOf[t] == -1) {
+		return true;
+	}
+
+	int a = blockNode(s), b = blockNode(t);
+	if (blockCut.tree[a] != blockCut.tree[b]) {
+		return true;
+	}
+
+	for (int id : avoidNodes) {
+		int x = indexOf(id);
+		if (x == s || x == t) {
+			return true;
+		}
+		if (x != -1 && cut[x] && blockCut.onPath(cutNode[x], a, b)) {
+			return true;
+		}
+	}
+
+	for (auto &[id1, id2] : avoidSegments) {
+		if (!isBridge(id1, id2)) {
+			continue;
+		}
+
+		// The bridge separates the endpoints when exactly one of them is below it
+		int below = std::max(piece[indexOf(id1)], piece[indexOf(id2)], [&](int p, int q) {
+			return bridgeTree.depth[p] < bridgeTree.depth[q];
+		});
+		if (bridgeTree.ancestor(below, piece[s]) != bridgeTree.ancestor(below, piece[t])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ---------------------------------------- Forest ---------------------------------------------------------------- //
+
+void BiconnectivityIndex::Forest::build(const std::vector<std::vector<int>> &adj, const std::vector<int> &nodeWeight) {
+	int n = adj.size();
+	int levels = 1;
+	while ((1 << levels) < n) {
+		levels++;
+	}
+
+	tree.assign(n, -1);
+	depth.assign(n, 0);
+	tin.assign(n, 0);
+	tout.assign(n, 0);
+	weight.assign(n, 0);
+	up.assign(levels, std::vector<int>(n, 0));
+
+	int timer = 0;
+	std::vector<std::pair<int, size_t>> stack;
+	for (int root = 0; root < n; root++) {
+		if (tree[root] != -1) {
+			continue;
+		}
+
+		tree[root] = root;
+		up[0][root] = root;
+		weight[root] = nodeWeight[root];
+		tin[root] = timer++;
+		stack.push_back({root, 0});
+
+		while (!stack.empty()) {
+			int v = stack.back().first;
+			if (stack.back().second == adj[v].size()) {
+				tout[v] = timer++;
+				stack.pop_back();
+				continue;
+			}
+
+			int u = adj[v][stack.back().second++];
+			if (tree[u] != -1) {
+				continue;
+			}
+			tree[u] = root;
+			depth[u] = depth[v] + 1;
+			up[0][u] = v;
+			weight[u] = weight[v] + nodeWeight[u];
+			tin[u] = timer++;
+			stack.push_back({u, 0});
+		}
+	}
+
+	for (int k = 1; k < levels; k++) {
+		for (int v = 0; v < n; v++) {
+			up[k][v] = up[k - 1][up[k - 1][v]];
+		}
+	}
+}
+
+bool BiconnectivityIndex::Forest::ancestor(int a, int b) const {
+	return tin[a] <= tin[b] && tout[b] <= tout[a];
+}
+
+int BiconnectivityIndex::Forest::lca(int a, int b) const {
+	if (ancestor(a, b)) {
+		return a;
+	}
+	if (ancestor(b, a)) {
+		return b;
+	}
+	for (int k = up.size() - 1; k >= 0; k--) {
+		if (!ancestor(up[k][a], b)) {
+			a = up[k][a];
+		}
+	}
+	return up[0][a];
+}
+
+bool BiconnectivityIndex::Forest::onPath(int x, int a, int b) const {
+	return ancestor(lca(a, b), x) && (ancestor(x, a) || ancestor(x, b));
+}
+
+int BiconnectivityIndex::Forest::weightOnPath(int a, int b) const {
+	int l = lca(a, b);
+	int above = up[0][l] == l ? 0 : weight[up[0][l]];
+	return weight[a] + weight[b] - weight[l] - above;
+}
+
+void precomputeBiconnectivity(Graph *graph) {
+	graph->setBiconnectivity(new BiconnectivityIndex(graph));
+}
+
+bool mayHaveAlternative(const Graph *graph, int source, int destination) {
+	BiconnectivityIndex *index = graph->getBiconnectivity();
+	return index == nullptr || index->hasDisjointAlternative(source, destination);
+}
+
+bool mayReachAvoiding(const Graph *graph, int source, int destination, const std::vector<int> &avoidNodes,
+					  const std::vector<std::pair<int, int>> &avoidSegments) {
+	BiconnectivityIndex *index = graph->getBiconnectivity();
+	return index == nullptr || !index->disconnects(source, destination, avoidNodes, avoidSegments);
+}
@@ -0,0 +1,140 @@
+/**
+* @file biconnectivity.h
+ * @brief Articulation points and bridges of the driving graph, to rule out routes before searching for them.
+ */
+
+#ifndef BICONNECTIVITY_H
+#define BICONNECTIVITY_H
+
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Block-cut tree and bridge tree of the driving graph (without `X` segments).
+ *
+ * Tarjan's depth-first search (which leaves its discovery order and low-links in Vertex::getNum() and
+ * Vertex::getLow()) splits the graph into biconnected blocks, joined at articulation points, and into
+ * 2-edge-connected pieces, joined by bridges. A location separates two others exactly when it is an articulation
+ * point on the path between them in the block-cut tree, and a segment does when it is a bridge on the path between
+ * them in the bridge tree; with both trees rooted and a lowest common ancestor table, either test takes O(log V).
+ *
+ * Segments are treated as undirected, as every segment is loaded in both directions. The index describes the graph
+ * as it was built, which should have no closures: closures only take connections away, so a pair it finds
+ * separated stays separated whatever is closed later.
+ */
+class BiconnectivityIndex {
+public:
+	/**
+	 * @brief Decomposes the open driving graph. O(V + E) for the search, O(V log V) for the trees.
+	 */
+	explicit BiconnectivityIndex(const Graph *graph);
+
+	bool isArticulationPoint(int id) const;
+	bool isBridge(int id1, int id2) const;
+	int getNumArticulationPoints() const;
+	int getNumBridges() const;
+
+	/**
+	 * @brief Tells whether no location other than the endpoints lies on every route between two locations.
+	 *
+	 * False when they are in different components or an articulation point lies on every route between them;
+	 * then no route avoids all the intermediate locations of the best one. O(log V).
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 */
+	bool hasDisjointAlternative(int source, int destination) const;
+
+	/**
+	 * @brief Tells whether avoiding some locations and segments certainly disconnects two locations.
+	 *
+	 * True when an endpoint is avoided, when the endpoints are in different components, or when one of the avoided
+	 * locations or segments alone separates them. A single avoided location or segment is decided exactly; several
+	 * may also separate the endpoints together, which only a search finds out. O((|avoidNodes| +
+	 * |avoidSegments|) log V).
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @param avoidNodes The IDs of the locations to avoid.
+	 * @param avoidSegments The segments to avoid, as pairs of location IDs.
+	 */
+	bool disconnects(int source, int destination, const std::vector<int> &avoidNodes,
+					 const std::vector<std::pair<int, int>> &avoidSegments) const;
+
+private:
+	/**
+	 * @brief Rooted forest with Euler tour times, binary lifting and a per-node weight summed from the root.
+	 */
+	struct Forest {
+		std::vector<int> tree;
+		std::vector<int> depth;
+		std::vector<int> tin, tout;
+		std::vector<int> weight;
+		std::vector<std::vector<int>> up;
+
+		void build(const std::vector<std::vector<int>> &adj, const std::vector<int> &nodeWeight);
+		bool ancestor(int a, int b) const;
+		int lca(int a, int b) const;
+		bool onPath(int x, int a, int b) const;
+		int weightOnPath(int a, int b) const;
+	};
+
+	void decompose();
+	void buildBlockCutTree();
+	void buildBridgeTree();
+	int indexOf(int id) const;
+	int blockNode(int v) const;
+
+	const Graph *graph;
+
+	std::vector<bool> cut;
+	std::vector<int> cutNode;
+	std::vector<int> blockOf;
+	std::vector<std::vector<int>> blocks;
+	int numCuts = 0;
+	Forest blockCut;
+
+	std::vector<Edge *> bridges;
+	std::vector<int> piece;
+	std::vector<std::pair<int, int>> bridgeTo; // bridgeTo[p] joins piece p to its parent piece
+	Forest bridgeTree;
+};
+
+/**
+ * @brief Builds the biconnectivity index of the graph and stores it there.
+ *
+ * The graph drops it whenever vertices, edges or weights change.
+ *
+ * @param graph The graph, without closures.
+ */
+void precomputeBiconnectivity(Graph *graph);
+
+/**
+ * @brief Tells whether a route that avoids all the intermediate locations of a best route may exist.
+ *
+ * False means it certainly does not: the biconnectivity index of the graph finds an articulation point between
+ * the two locations. Without an index the answer is true.
+ *
+ * @param graph The graph.
+ * @param source The ID of the source location.
+ * @param destination The ID of the destination location.
+ */
+bool mayHaveAlternative(const Graph *graph, int source, int destination);
+
+/**
+ * @brief Tells whether a driving route may exist once some locations and segments are avoided.
+ *
+ * False means it certainly does not, according to the biconnectivity index of the graph. Without an index the
+ * answer is true.
+ *
+ * @param graph The graph.
+ * @param source The ID of the source location.
+ * @param destination The ID of the destination location.
+ * @param avoidNodes The IDs of the locations to avoid.
+ * @param avoidSegments The segments to avoid, as pairs of location IDs.
+ */
+bool mayReachAvoiding(const Graph *graph, int source, int destination, const std::vector<int> &avoidNodes,
+					  const std::vector<std::pair<int, int>> &avoidSegments);
+
+#endif //BICONNECTIVITY_H
@@ -0,0 +1,257 @@
+#include "components.h"
+#include <algorithm>
+#include <climits>
+#include <map>
+
+ComponentIndex::ComponentIndex(const Graph *graph) : graph(graph), owner(graph->getNumVertex(), -1) {
+	int n = graph->getNumVertex();
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+
+	for (Metric metric : {Metric::Driving, Metric::Walking}) {
+		Labels &labels = of(metric);
+		labels.label.assign(n, -1);
+		std::vector<int> stack;
+
+		for (int s = 0; s < n; s++) {
+			if (labels.label[s] != -1 || vertices[s]->isClosed()) {
+				continue;
+			}
+			int label = newLabel(labels);
+			setLabel(labels, s, label);
+			stack.push_back(s);
+
+			while (!stack.empty()) {
+				int v = stack.back();
+				stack.pop_back();
+				forEachNeighbour(v, metric, [&](int u) {
+					if (labels.label[u] == -1) {
+						setLabel(labels, u, label);
+						stack.push_back(u);
+					}
+				});
+			}
+		}
+	}
+}
+
+bool ComponentIndex::usable(const Edge *edge, Metric metric) {
+	return edge->getWeight(metric) != INT_MAX;
+}
+
+// Neighbours through open segments usable with the metric, in either direction
+
+template <typename Visit>
+void ComponentIndex::forEachNeighbour(int v, Metric metric, Visit visit) const {
+	const Vertex *vertex = graph->getVertexSet()[v];
+	for (auto e : vertex->getAdj()) {
+		if (usable(e, metric)) {
+			visit(e->getDest()->getIndex());
+		}
+	}
+	for (auto e : vertex->getIncoming()) {
+		if (usable(e, metric)) {
+			visit(e->getOrig()->getIndex());
+		}
+	}
+}
+
+int ComponentIndex::newLabel(Labels &labels) {
+	labels.size.push_back(0);
+	return labels.size.size() - 1;
+}
+
+// Moves a vertex to another component (-1 for none), keeping the sizes and the number of components
+
+void ComponentIndex::setLabel(Labels &labels, int v, int label) {
+	int old = labels.label[v];
+	if (old != -1 && --labels.size[old] == 0) {
+		labels.count--;
+	}
+	if (label != -1 && labels.size[label]++ == 0) {
+		labels.count++;
+	}
+	labels.label[v] = label;
+}
+
+ComponentIndex::Labels &ComponentIndex::of(Metric metric) {
+	return metric == Metric::Driving ? driving : walking;
+}
+
+const ComponentIndex::Labels &ComponentIndex::of(Metric metric) const {
+	return metric == Metric::Driving ? driving : walking;
+}
+
+bool ComponentIndex::connected(Metric metric, const Vertex *a, const Vertex *b) const {
+	if (a->isClosed() || b->isClosed()) {
+		return false;
+	}
+	const Labels &labels = of(metric);
+	return a == b || (labels.label[a->getIndex()] != -1 && labels.label[a->getIndex()] == labels.label[b->getIndex()]);
+}
+
+int ComponentIndex::getNumComponents(Metric metric) const {
+	return of(metric).count;
+}
+
+void ComponentIndex::detached(const std::vector<Edge *> &edges, const Vertex *closed) {
+	for (Metric metric : {Metric::Driving, Metric::Walking}) {
+		Labels &labels = of(metric);
+		if (closed != nullptr) {
+			setLabel(labels, closed->getIndex(), -1);
+		}
+
+		// Only the components holding two or more open endpoints of the detached edges can split
+		std::map<int, std::vector<int>> endpoints;
+		for (auto e : edges) {
+			if (!usable(e, metric)) {
+				continue;
+			}
+			for (const Vertex *v : {e->getOrig(), e->getDest()}) {
+				if (!v->isClosed()) {
+					endpoints[labels.label[v->getIndex()]].push_back(v->getIndex());
+				}
+			}
+		}
+
+		for (auto &[label, group] : endpoints) {
+			std::sort(group.begin(), group.end());
+			group.erase(std::unique(group.begin(), group.end()), group.end());
+			if (group.size() > 1) {
+				split(metric, group);
+			}
+		}
+	}
+}
+
+void ComponentIndex::attached(const std::vector<Edge *> &edges, const Vertex *reopened) {
+	for (Metric metric : {Metric::Driving, Metric::Walking}) {
+		Labels &labels = of(metric);
+		if (reopened != nullptr && labels.label[reopened->getIndex()] == -1) {
+			setLabel(labels, reopened->getIndex(), newLabel(labels));
+		}
+
+		for (auto e : edges) {
+			if (usable(e, metric)) {
+				merge(metric, e->getOrig()->getIndex(), e->getDest()->getIndex());
+			}
+		}
+	}
+}
+
+// Joins the components of a and b, relabelling the smaller one with a search that stays inside it
+
+void ComponentIndex::merge(Metric metric, int a, int b) {
+	Labels &labels = of(metric);
+	int la = labels.label[a], lb = labels.label[b];
+	if (la == lb) {
+		return;
+	}
+	if (labels.size[la] < labels.size[lb]) {
+		std::swap(a, b);
+		std::swap(la, lb);
+	}
+
+	std::vector<int> stack = {b};
+	setLabel(labels, b, la);
+	while (!stack.empty()) {
+		int v = stack.back();
+		stack.pop_back();
+		forEachNeighbour(v, metric, [&](int u) {
+			if (labels.label[u] == lb) {
+				setLabel(labels, u, la);
+				stack.push_back(u);
+			}
+		});
+	}
+}
+
+/*
+ * The endpoints were connected before the edges were detached. A breadth-first search is grown from each of them,
+ * one vertex at a time in turn; two searches that meet are merged. A search that runs out of vertices has found a
+ * whole component, which gets a new label. Once a single search is left, whatever it has not reached keeps the old
+ * label, so the work done is proportional to the pieces that were cut off (plus the time for the searches to meet).
+ */
+
+void ComponentIndex::split(Metric metric, const std::vector<int> &endpoints) {
+	Labels &labels = of(metric);
+	int k = endpoints.size();
+
+	std::vector<std::vector<int>> queues(k);
+	std::vector<size_t> heads(k, 0);
+	std::vector<int> group(k);
+	std::vector<bool> active(k, true);
+
+	auto find = [&](int i) {
+		while (group[i] != i) {
+			i = group[i] = group[group[i]];
+		}
+		return i;
+	};
+
+	for (int i = 0; i < k; i++) {
+		group[i] = i;
+		owner[endpoints[i]] = i;
+		touched.push_back(endpoints[i]);
+		queues[i].push_back(endpoints[i]);
+	}
+
+	int groups = k;
+	while (groups > 1) {
+		for (int i = 0; i < k && groups > 1; i++) {
+			if (!active[i]) {
+				continue;
+			}
+
+			if (heads[i] == queues[i].size()) {
+				int label = newLabel(labels);
+				for (int v : touched) {
+					if (find(owner[v]) == i) {
+						setLabel(labels, v, label);
+					}
+				}
+				active[i] = false;
+				groups--;
+				continue;
+			}
+
+			int v = queues[i][heads[i]++];
+			forEachNeighbour(v, metric, [&](int u) {
+				if (owner[u] == -1) {
+					owner[u] = i;
+					touched.push_back(u);
+					queues[i].push_back(u);
+					return;
+				}
+
+				int j = find(owner[u]);
+				if (j != i) {
+					group[j] = i;
+					queues[i].insert(queues[i].end(), queues[j].begin() + heads[j], queues[j].end());
+					std::vector<int>().swap(queues[j]);
+					active[j] = false;
+					groups--;
+				}
+			});
+		}
+	}
+
+	for (int v : touched) {
+		owner[v] = -1;
+	}
+	touched.clear();
+}
+
+void precomputeComponents(Graph *graph) {
+	graph->setComponents(new ComponentIndex(graph));
+}
+
+bool mayReach(const Graph *graph, Metric metric, int source, int destination) {
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+	if (src == nullptr || dest == nullptr) {
+		return false;
+	}
+
+	ComponentIndex *components = graph->getComponents();
+	return components == nullptr || components->connected(metric, src, dest);
+}
@@ -0,0 +1,104 @@
+/**
+* @file components.h
+ * @brief Connected component labels of the driving and walking graphs, kept up to date under closures.
+ */
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Component label of every location, for the driving graph (without `X` segments) and the walking graph.
+ *
+ * Segments are treated as undirected, so two locations with different labels certainly cannot reach each other;
+ * every segment is loaded in both directions, so on the maps used here the converse holds too. Closed locations
+ * belong to no component.
+ *
+ * The graph notifies the index of the edges detached and attached by closures. A closure can only split the
+ * components that contain the endpoints of the detached edges: searches are grown from those endpoints in turn
+ * until they meet, and a search that runs out of vertices before meeting the others is a new component, so the
+ * cost is bounded by the smaller pieces. A reopening merges two components by relabelling the smaller one.
+ */
+class ComponentIndex {
+public:
+	/**
+	 * @brief Labels the components of the open graph. O(V + E).
+	 */
+	explicit ComponentIndex(const Graph *graph);
+
+	/**
+	 * @brief Tells whether two locations are in the same component of a metric's graph. O(1).
+	 */
+	bool connected(Metric metric, const Vertex *a, const Vertex *b) const;
+
+	/**
+	 * @brief Number of components of a metric's graph, not counting closed locations.
+	 */
+	int getNumComponents(Metric metric) const;
+
+	/**
+	 * @brief Updates the labels after edges were detached from the graph.
+	 *
+	 * @param edges The edges detached.
+	 * @param closed The location closed along with them, if any.
+	 */
+	void detached(const std::vector<Edge *> &edges, const Vertex *closed = nullptr);
+
+	/**
+	 * @brief Updates the labels after edges were attached to the graph.
+	 *
+	 * @param edges The edges attached.
+	 * @param reopened The location reopened along with them, if any.
+	 */
+	void attached(const std::vector<Edge *> &edges, const Vertex *reopened = nullptr);
+
+private:
+	struct Labels {
+		std::vector<int> label;
+		std::vector<int> size;
+		int count = 0;
+	};
+
+	static bool usable(const Edge *edge, Metric metric);
+	template <typename Visit>
+	void forEachNeighbour(int v, Metric metric, Visit visit) const;
+	static int newLabel(Labels &labels);
+	void setLabel(Labels &labels, int v, int label);
+	void merge(Metric metric, int a, int b);
+	void split(Metric metric, const std::vector<int> &endpoints);
+
+	Labels &of(Metric metric);
+	const Labels &of(Metric metric) const;
+
+	const Graph *graph;
+	Labels driving;
+	Labels walking;
+
+	// Search buffers for split(), reset through `touched`
+	std::vector<int> owner;
+	std::vector<int> touched;
+};
+
+/**
+ * @brief Builds the component labels and stores them in the graph, which keeps them up to date.
+ *
+ * @param graph The graph.
+ */
+void precomputeComponents(Graph *graph);
+
+/**
+ * @brief Tells whether a route between two locations may exist.
+ *
+ * False means the route certainly does not exist: a location does not exist, or the component labels of the
+ * graph put them apart. Without labels the answer is true. O(1).
+ *
+ * @param graph The graph.
+ * @param metric The metric of the route.
+ * @param source The ID of the source location.
+ * @param destination The ID of the destination location.
+ */
+bool mayReach(const Graph *graph, Metric metric, int source, int destination);
+
+#endif //COMPONENTS_H
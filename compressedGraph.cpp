@@ -0,0 +1,214 @@
+#include "compressedGraph.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+CompressedGraph::CompressedGraph(const Graph *graph) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int n = vertices.size();
+
+	offsets.reserve(n + 1);
+	ids.reserve(n);
+	byId.resize(n);
+
+	struct Entry {
+		int target;
+		Kind kind;
+		Edge *edge;
+	};
+	std::vector<Entry> entries;
+
+	for (int v = 0; v < n; v++) {
+		offsets.push_back(bytes.size());
+		ids.push_back(vertices[v]->getId());
+		byId[v] = v;
+
+		entries.clear();
+		for (auto e : vertices[v]->getAdj()) {
+			int u = e->getDest()->getIndex();
+			Edge *rev = e->getReverse();
+			bool paired = rev != nullptr && !rev->isClosed() && u != v
+				&& rev->getDriving() == e->getDriving() && rev->getWalking() == e->getWalking();
+			entries.push_back({u, paired ? (v < u ? Owned : Shared) : OneWay, e});
+		}
+		std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+			return a.target < b.target;
+		});
+
+		// The first target is stored relative to v (zigzag encoded), the others relative to the previous one
+		int prev = v;
+		for (size_t i = 0; i < entries.size(); i++) {
+			int delta = entries[i].target - prev;
+			uint32_t value = i == 0 ? (delta >= 0 ? 2u * delta : 2u * -delta - 1) : delta;
+			writeVarint(value << 2 | entries[i].kind, bytes);
+			if (entries[i].kind != Shared) {
+				writeWeights(entries[i].edge->getDriving(), entries[i].edge->getWalking());
+			}
+			prev = entries[i].target;
+		}
+	}
+	offsets.push_back(bytes.size());
+
+	std::sort(byId.begin(), byId.end(), [this](int a, int b) { return ids[a] < ids[b]; });
+
+	bytes.shrink_to_fit();
+	overflow.shrink_to_fit();
+}
+
+void CompressedGraph::writeVarint(uint32_t value, std::vector<uint8_t> &out) {
+	while (value >= 0x80) {
+		out.push_back((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out.push_back(value);
+}
+
+uint32_t CompressedGraph::readVarint(const uint8_t *&in) {
+	uint32_t value = 0;
+	for (int shift = 0; ; shift += 7) {
+		uint8_t byte = *in++;
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+}
+
+void CompressedGraph::writeWeights(int driving, int walking) {
+	int weights[2] = {driving, walking};
+	uint16_t values[2];
+
+	for (int i = 0; i < 2; i++) {
+		if (weights[i] == INT_MAX) {
+			values[i] = UNUSABLE;
+		}
+		else if (weights[i] >= 0 && weights[i] < ESCAPE) {
+			values[i] = weights[i];
+		}
+		else {
+			values[i] = ESCAPE;
+		}
+		bytes.push_back(values[i] & 0xFF);
+		bytes.push_back(values[i] >> 8);
+	}
+
+	for (int i = 0; i < 2; i++) {
+		if (values[i] == ESCAPE) {
+			writeVarint(overflow.size(), bytes);
+			overflow.push_back(weights[i]);
+		}
+	}
+}
+
+void CompressedGraph::readHeader(const uint8_t *&in, int &target, Kind &kind, bool first) {
+	uint32_t value = readVarint(in);
+	uint32_t delta = value >> 2;
+	kind = (Kind)(value & 3);
+	target += first ? (delta & 1 ? -(int)(delta + 1) / 2 : (int)delta / 2) : (int)delta;
+}
+
+int CompressedGraph::readWeights(const uint8_t *&in, Metric metric) const {
+	uint16_t driving = in[0] | in[1] << 8;
+	uint16_t walking = in[2] | in[3] << 8;
+	in += 4;
+
+	int drivingWeight = driving == ESCAPE ? overflow[readVarint(in)] : driving;
+	int walkingWeight = walking == ESCAPE ? overflow[readVarint(in)] : walking;
+
+	uint16_t value = metric == Metric::Driving ? driving : walking;
+	if (value == UNUSABLE) {
+		return -1;
+	}
+	return metric == Metric::Driving ? drivingWeight : walkingWeight;
+}
+
+int CompressedGraph::sharedWeight(int owner, int v, Metric metric) const {
+	const uint8_t *in = bytes.data() + offsets[owner];
+	const uint8_t *end = bytes.data() + offsets[owner + 1];
+	int target = owner;
+	bool first = true;
+	int best = -1;
+
+	// Parallel segments between the same locations resolve to the cheapest one
+	while (in < end) {
+		Kind kind;
+		readHeader(in, target, kind, first);
+		first = false;
+		if (kind == Shared) {
+			continue;
+		}
+
+		int weight = readWeights(in, metric);
+		if (kind == Owned && target == v && weight != -1 && (best == -1 || weight < best)) {
+			best = weight;
+		}
+	}
+	return best;
+}
+
+int CompressedGraph::numVertex() const {
+	return ids.size();
+}
+
+int CompressedGraph::findIndex(int id) const {
+	auto it = std::lower_bound(byId.begin(), byId.end(), id, [this](int index, int value) {
+		return ids[index] < value;
+	});
+	return it != byId.end() && ids[*it] == id ? *it : -1;
+}
+
+int CompressedGraph::getId(int index) const {
+	return ids[index];
+}
+
+size_t CompressedGraph::memoryUsage() const {
+	return sizeof(*this) + offsets.capacity() * sizeof(uint32_t) + bytes.capacity()
+		+ (overflow.capacity() + ids.capacity() + byId.capacity()) * sizeof(int);
+}
+
+Route CompressedGraph::route(int source, int destination, Metric metric) const {
+	int s = findIndex(source);
+	int t = findIndex(destination);
+	if (s == -1 || t == -1) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<long> dist(numVertex(), LONG_MAX);
+	std::vector<int> parent(numVertex(), -1);
+	std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>,
+		std::greater<std::pair<long, int>>> queue;
+
+	dist[s] = 0;
+	queue.emplace(0, s);
+
+	while (!queue.empty()) {
+		auto [d, v] = queue.top();
+		queue.pop();
+		if (d != dist[v]) {
+			continue;
+		}
+		if (v == t) {
+			break;
+		}
+
+		forEachArc(v, metric, [&](int u, int weight) {
+			if (d + weight < dist[u]) {
+				dist[u] = d + weight;
+				parent[u] = v;
+				queue.emplace(dist[u], u);
+			}
+		});
+	}
+
+	if (dist[t] == LONG_MAX) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<int> route;
+	for (int v = t; v != -1; v = parent[v]) {
+		route.push_back(ids[v]);
+	}
+	std::reverse(route.begin(), route.end());
+	return {route, (int)route.size(), (int)dist[t]};
+}
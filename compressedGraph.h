@@ -0,0 +1,116 @@
+/**
+* @file compressedGraph.h
+ * @brief Compact read-only copy of a graph for maps too large for the pointer-based representation.
+ */
+
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+
+/**
+ * @brief Read-only copy of the open segments of a graph, encoded in a byte stream per vertex.
+ *
+ * The neighbours of a vertex are sorted by dense index and stored as variable-length deltas. A segment whose
+ * two directions have the same weights is stored once: its weights are kept by the endpoint with the lower
+ * index, and the other endpoint only keeps a reference to it. Other arcs are stored one-way at their origin.
+ * Driving and walking times take 16 bits each; larger values escape to an overflow table, so no time is
+ * rounded. Compared with the Graph (two Edge objects and four list entries per segment, plus the strings of
+ * each vertex) this takes several times less memory, and arcs are decoded on the fly during a search.
+ */
+class CompressedGraph {
+public:
+	/**
+	 * @brief Encodes the open segments of a graph.
+	 *
+	 * The time complexity is O(V + E log D), where D is the maximum degree. Later changes to the graph
+	 * (closures, new weights) are not reflected.
+	 *
+	 * @param graph The graph to copy.
+	 */
+	explicit CompressedGraph(const Graph *graph);
+
+	int numVertex() const;
+
+	/**
+	 * @brief Dense index of a location, or -1 if it does not exist. O(log V).
+	 */
+	int findIndex(int id) const;
+
+	int getId(int index) const;
+
+	/**
+	 * @brief Number of bytes used by the representation.
+	 */
+	size_t memoryUsage() const;
+
+	/**
+	 * @brief Computes the best route between two locations with Dijkstra, decoding the arcs as they are relaxed.
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @param metric The weight to use.
+	 * @return The route, with time -1 if there is none.
+	 */
+	Route route(int source, int destination, Metric metric) const;
+
+	/**
+	 * @brief Calls visit(target, weight) for every usable arc leaving a vertex.
+	 *
+	 * @param v The dense index of the vertex.
+	 * @param metric The weight to use.
+	 * @param visit The function called for each arc.
+	 */
+	template <typename Visit>
+	void forEachArc(int v, Metric metric, Visit visit) const;
+
+private:
+	enum Kind : uint8_t {Owned = 0, Shared = 1, OneWay = 2};
+
+	// 16-bit weight values with a special meaning: the weight is in the overflow table, or the arc is unusable
+	static const uint16_t ESCAPE = 0xFFFE;
+	static const uint16_t UNUSABLE = 0xFFFF;
+
+	std::vector<uint32_t> offsets;
+	std::vector<uint8_t> bytes;
+	std::vector<int> overflow;
+	std::vector<int> ids;
+	// Indices sorted by ID, for findIndex
+	std::vector<int> byId;
+
+	static void writeVarint(uint32_t value, std::vector<uint8_t> &out);
+	static uint32_t readVarint(const uint8_t *&in);
+	void writeWeights(int driving, int walking);
+
+	// Reads the header of an entry, leaving `in` at its weights
+	static void readHeader(const uint8_t *&in, int &target, Kind &kind, bool first);
+	// Reads the weights of an entry; -1 if the arc is unusable with the metric
+	int readWeights(const uint8_t *&in, Metric metric) const;
+	// Weight of a segment stored once, looked up in the list of the endpoint that keeps it
+	int sharedWeight(int owner, int v, Metric metric) const;
+};
+
+template <typename Visit>
+void CompressedGraph::forEachArc(int v, Metric metric, Visit visit) const {
+	const uint8_t *in = bytes.data() + offsets[v];
+	const uint8_t *end = bytes.data() + offsets[v + 1];
+	int target = v;
+	bool first = true;
+
+	while (in < end) {
+		Kind kind;
+		readHeader(in, target, kind, first);
+		first = false;
+
+		int weight = kind == Shared ? sharedWeight(target, v, metric) : readWeights(in, metric);
+		if (weight != -1) {
+			visit(target, weight);
+		}
+	}
+}
+
+#endif //COMPRESSEDGRAPH_H
@@ -0,0 +1,365 @@
+#include "contractionHierarchy.h"
+#include "graphSnapshot.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+namespace {
+
+// Maximum number of vertices settled by a witness search before giving up (which only costs extra shortcuts)
+const int WITNESS_SETTLE_LIMIT = 500;
+
+struct Arc {
+	int node;
+	int weight;
+	int middle;
+};
+
+using Entry = std::pair<long, int>;
+using MinQueue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+// Remaining (not yet contracted) graph while the hierarchy is built
+
+class Contraction {
+public:
+	explicit Contraction(const GraphSnapshot &snapshot) : out(snapshot.numVertex()), in(snapshot.numVertex()),
+		contractedNeighbours(snapshot.numVertex(), 0),
+		dist(snapshot.numVertex(), INT_MAX) {
+		for (int v = 0; v < snapshot.numVertex(); v++) {
+			for (int i = snapshot.offsets[v]; i < snapshot.offsets[v + 1]; i++) {
+				addArc(v, snapshot.targets[i], snapshot.weights[i], -1);
+			}
+		}
+	}
+
+	void addArc(int from, int to, int weight, int middle) {
+		if (from == to) {
+			return;
+		}
+		for (auto &a : out[from]) {
+			if (a.node == to) {
+				if (weight < a.weight) {
+					a = {to, weight, middle};
+					for (auto &b : in[to]) {
+						if (b.node == from) {
+							b = {from, weight, middle};
+						}
+					}
+				}
+				return;
+			}
+		}
+		out[from].push_back({to, weight, middle});
+		in[to].push_back({from, weight, middle});
+	}
+
+	// Shortcuts needed to contract v: for each pair u -> v -> w without a witness path avoiding v
+	void shortcuts(int v, std::vector<std::pair<int, int>> &result) {
+		result.clear();
+
+		for (int i = 0; i < (int)in[v].size(); i++) {
+			const Arc &a = in[v][i];
+			long limit = 0;
+			for (auto &b : out[v]) {
+				if (b.node != a.node) {
+					limit = std::max(limit, (long)a.weight + b.weight);
+				}
+			}
+			witnessSearch(a.node, v, limit);
+
+			for (int j = 0; j < (int)out[v].size(); j++) {
+				const Arc &b = out[v][j];
+				if (b.node != a.node && dist[b.node] > (long)a.weight + b.weight) {
+					result.emplace_back(i, j);
+				}
+			}
+			clearWitness();
+		}
+	}
+
+	int priority(int v) {
+		std::vector<std::pair<int, int>> added;
+		shortcuts(v, added);
+		return (int)added.size() - (int)(in[v].size() + out[v].size()) + contractedNeighbours[v];
+	}
+
+	// Contracts v and returns its final upward (out) and downward (in) arcs
+	void contract(int v, std::vector<Arc> &up, std::vector<Arc> &down) {
+		std::vector<std::pair<int, int>> added;
+		shortcuts(v, added);
+
+		up = out[v];
+		down = in[v];
+
+		for (auto &p : added) {
+			const Arc &a = down[p.first];
+			const Arc &b = up[p.second];
+			addArc(a.node, b.node, a.weight + b.weight, v);
+		}
+
+		for (auto &a : down) {
+			removeArc(out[a.node], v);
+			contractedNeighbours[a.node]++;
+		}
+		for (auto &b : up) {
+			removeArc(in[b.node], v);
+			contractedNeighbours[b.node]++;
+		}
+
+		out[v].clear();
+		in[v].clear();
+	}
+
+private:
+	static void removeArc(std::vector<Arc> &arcs, int node) {
+		arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [node](const Arc &a) { return a.node == node; }), arcs.end());
+	}
+
+	void witnessSearch(int source, int ignored, long limit) {
+		MinQueue queue;
+		dist[source] = 0;
+		touched.push_back(source);
+		queue.emplace(0, source);
+		int settled = 0;
+
+		while (!queue.empty() && settled < WITNESS_SETTLE_LIMIT) {
+			auto [d, v] = queue.top();
+			queue.pop();
+			if (d != dist[v]) {
+				continue;
+			}
+			if (d > limit) {
+				break;
+			}
+			settled++;
+
+			for (auto &a : out[v]) {
+				if (a.node == ignored) {
+					continue;
+				}
+				long nd = d + a.weight;
+				if (nd < dist[a.node]) {
+					if (dist[a.node] == INT_MAX) {
+						touched.push_back(a.node);
+					}
+					dist[a.node] = nd;
+					queue.emplace(nd, a.node);
+				}
+			}
+		}
+	}
+
+	void clearWitness() {
+		for (int v : touched) {
+			dist[v] = INT_MAX;
+		}
+		touched.clear();
+	}
+
+	std::vector<std::vector<Arc>> out, in;
+	std::vector<int> contractedNeighbours;
+	std::vector<long> dist;
+	std::vector<int> touched;
+};
+
+}
+
+UpwardSearch::UpwardSearch(int n): dist(n, INT_MAX), parent(n, -1), parentArc(n, -1) {}
+
+/********************** Construction  ****************************/
+
+ContractionHierarchy::ContractionHierarchy(const Graph *graph, Metric metric): metric(metric) {
+	GraphSnapshot snapshot = makeSnapshot(graph, metric);
+	int n = snapshot.numVertex();
+	Contraction contraction(snapshot);
+
+	rank.assign(n, -1);
+	order.reserve(n);
+
+	std::vector<std::vector<Arc>> up(n), down(n);
+	MinQueue queue;
+	for (int v = 0; v < n; v++) {
+		queue.emplace(contraction.priority(v), v);
+	}
+
+	// Lazy updates: a popped vertex is only contracted if its priority is still the smallest
+	while (!queue.empty()) {
+		auto [p, v] = queue.top();
+		queue.pop();
+		if (rank[v] >= 0) {
+			continue;
+		}
+
+		long current = contraction.priority(v);
+		if (!queue.empty() && current > queue.top().first) {
+			queue.emplace(current, v);
+			continue;
+		}
+
+		rank[v] = order.size();
+		order.push_back(v);
+		contraction.contract(v, up[v], down[v]);
+	}
+
+	upOffsets.push_back(0);
+	downOffsets.push_back(0);
+	for (int v = 0; v < n; v++) {
+		for (auto &a : up[v]) {
+			upHeads.push_back(a.node);
+			upWeights.push_back(a.weight);
+			upMiddles.push_back(a.middle);
+		}
+		for (auto &a : down[v]) {
+			downTails.push_back(a.node);
+			downWeights.push_back(a.weight);
+			downMiddles.push_back(a.middle);
+		}
+		upOffsets.push_back(upHeads.size());
+		downOffsets.push_back(downTails.size());
+	}
+}
+
+int ContractionHierarchy::size() const {
+	return rank.size();
+}
+
+Metric ContractionHierarchy::getMetric() const {
+	return metric;
+}
+
+int ContractionHierarchy::getRank(int v) const {
+	return rank[v];
+}
+
+const std::vector<int> &ContractionHierarchy::getOrder() const {
+	return order;
+}
+
+int ContractionHierarchy::getNumArcs() const {
+	return upHeads.size() + downTails.size();
+}
+
+/********************** Queries  ****************************/
+
+void ContractionHierarchy::upwardSearch(int source, bool backward, UpwardSearch &search) const {
+	if ((int)search.dist.size() != size()) {
+		search = UpwardSearch(size());
+	}
+	for (int v : search.settled) {
+		search.dist[v] = INT_MAX;
+		search.parent[v] = -1;
+		search.parentArc[v] = -1;
+	}
+	search.settled.clear();
+
+	MinQueue queue;
+	search.dist[source] = 0;
+	queue.emplace(0, source);
+
+	while (!queue.empty()) {
+		auto [d, v] = queue.top();
+		queue.pop();
+		if (d != search.dist[v]) {
+			continue;
+		}
+		search.settled.push_back(v);
+
+		int begin = backward ? downOffsets[v] : upOffsets[v];
+		int end = backward ? downOffsets[v + 1] : upOffsets[v + 1];
+
+		for (int arc = begin; arc < end; arc++) {
+			int u = backward ? downTails[arc] : upHeads[arc];
+			long nd = d + (backward ? downWeights[arc] : upWeights[arc]);
+			if (nd < search.dist[u]) {
+				search.dist[u] = nd;
+				search.parent[u] = v;
+				search.parentArc[u] = arc;
+				queue.emplace(nd, u);
+			}
+		}
+	}
+}
+
+long ContractionHierarchy::distance(int source, int target) const {
+	UpwardSearch forward(size()), backward(size());
+	upwardSearch(source, false, forward);
+	upwardSearch(target, true, backward);
+
+	long best = INT_MAX;
+	for (int v : forward.settled) {
+		if (backward.dist[v] != INT_MAX) {
+			best = std::min(best, forward.dist[v] + backward.dist[v]);
+		}
+	}
+	return best;
+}
+
+std::vector<int> ContractionHierarchy::path(int source, int target) const {
+	UpwardSearch forward(size()), backward(size());
+	upwardSearch(source, false, forward);
+	upwardSearch(target, true, backward);
+
+	long best = INT_MAX;
+	int meeting = -1;
+	for (int v : forward.settled) {
+		if (backward.dist[v] != INT_MAX && forward.dist[v] + backward.dist[v] < best) {
+			best = forward.dist[v] + backward.dist[v];
+			meeting = v;
+		}
+	}
+
+	std::vector<int> result;
+	if (meeting >= 0) {
+		unpackPath(forward, backward, meeting, result);
+	}
+	return result;
+}
+
+void ContractionHierarchy::unpackPath(const UpwardSearch &forward, const UpwardSearch &backward, int meeting, std::vector<int> &out) const {
+	// Forward tree: edges parent -> v are arcs of the upward graph
+	std::vector<int> chain;
+	for (int v = meeting; forward.parent[v] >= 0; v = forward.parent[v]) {
+		chain.push_back(v);
+	}
+
+	int v = meeting;
+	while (forward.parent[v] >= 0) {
+		v = forward.parent[v];
+	}
+	out.push_back(v);
+
+	for (auto it = chain.rbegin(); it != chain.rend(); it++) {
+		int arc = forward.parentArc[*it];
+		unpackArc(forward.parent[*it], *it, upMiddles[arc], out);
+	}
+
+	// Backward tree: edges v -> parent are arcs of the downward graph
+	for (int u = meeting; backward.parent[u] >= 0; u = backward.parent[u]) {
+		int arc = backward.parentArc[u];
+		unpackArc(u, backward.parent[u], downMiddles[arc], out);
+	}
+}
+
+// Appends the vertices of the edge from -> to after `from`, replacing shortcuts by the edges they bypass
+
+void ContractionHierarchy::unpackArc(int from, int to, int middle, std::vector<int> &out) const {
+	if (middle < 0) {
+		out.push_back(to);
+		return;
+	}
+
+	// from -> middle arrives at the lower ranked middle, middle -> to leaves it
+	for (int arc = downOffsets[middle]; arc < downOffsets[middle + 1]; arc++) {
+		if (downTails[arc] == from) {
+			unpackArc(from, middle, downMiddles[arc], out);
+			break;
+		}
+	}
+	for (int arc = upOffsets[middle]; arc < upOffsets[middle + 1]; arc++) {
+		if (upHeads[arc] == to) {
+			unpackArc(middle, to, upMiddles[arc], out);
+			break;
+		}
+	}
+}
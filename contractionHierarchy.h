@@ -0,0 +1,123 @@
+/**
+* @file contractionHierarchy.h
+ * @brief Contraction hierarchy over the driving or walking metric of a graph.
+ *
+ * The vertices are contracted one by one in order of importance, adding shortcut edges that preserve the
+ * shortest distances between the remaining ones. A shortest path query then only needs two small searches
+ * that go up in the hierarchy, one from each endpoint. The hierarchy is the base of the many-to-many
+ * distance tables and of other speed-up techniques.
+ */
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Reusable buffers for an upward search in a contraction hierarchy.
+ *
+ * An upward search runs until its queue is empty, so every vertex it reaches is settled. Only the entries of
+ * the settled vertices are reset between searches, so a search costs time proportional to its search space
+ * and not to the size of the graph.
+ */
+struct UpwardSearch {
+	std::vector<long> dist;
+	std::vector<int> parent;
+	std::vector<int> parentArc;
+	std::vector<int> settled;
+
+	explicit UpwardSearch(int n = 0);
+};
+
+/**
+ * @brief Contraction hierarchy built from a snapshot of the open edges of a graph.
+ *
+ * Vertices are identified by their dense index. The upward graph keeps, for each vertex, the edges to
+ * higher ranked vertices; the downward graph keeps, for each vertex, the edges that arrive at it from
+ * higher ranked vertices. Shortcuts remember the vertex they bypass so paths can be unpacked.
+ */
+class ContractionHierarchy {
+public:
+	/**
+	 * @brief Builds the hierarchy of a graph for one metric.
+	 *
+	 * Vertices are ordered by edge difference plus number of contracted neighbours, updated lazily,
+	 * and witness searches are limited in size, so the construction is roughly O(V log V) on road maps.
+	 *
+	 * @param graph The graph, whose closures are taken into account.
+	 * @param metric The weight to use.
+	 */
+	ContractionHierarchy(const Graph *graph, Metric metric);
+
+	int size() const;
+	Metric getMetric() const;
+
+	/**
+	 * @brief Rank of a vertex in the hierarchy (0 is contracted first).
+	 */
+	int getRank(int v) const;
+
+	/**
+	 * @brief Vertices sorted by increasing rank.
+	 */
+	const std::vector<int> &getOrder() const;
+
+	/**
+	 * @brief Number of edges of the hierarchy, shortcuts included.
+	 */
+	int getNumArcs() const;
+
+	/**
+	 * @brief Runs a search from a vertex that only goes up in the hierarchy.
+	 *
+	 * A forward search follows the edges leaving the vertices and a backward search follows the edges
+	 * arriving at them. The settled vertices are left in `search.settled`, with their distances.
+	 *
+	 * @param source The dense index of the start vertex.
+	 * @param backward Direction of the search.
+	 * @param search The buffers to use, previous results are cleared.
+	 */
+	void upwardSearch(int source, bool backward, UpwardSearch &search) const;
+
+	/**
+	 * @brief Shortest distance between two vertices (INT_MAX if unreachable).
+	 */
+	long distance(int source, int target) const;
+
+	/**
+	 * @brief Shortest path between two vertices as dense indexes, empty if unreachable.
+	 */
+	std::vector<int> path(int source, int target) const;
+
+	/**
+	 * @brief Appends the original vertices of the path between the two vertices of the forward search
+	 *        tree in `forward` and the backward search tree in `backward` that meet at `meeting`.
+	 */
+	void unpackPath(const UpwardSearch &forward, const UpwardSearch &backward, int meeting, std::vector<int> &out) const;
+
+	/**
+	 * @brief Edges of the upward (downward) graph of a vertex, as [begin, end) indexes for
+	 *        getUpHead()/getUpWeight() (getDownTail()/getDownWeight()).
+	 */
+	int upBegin(int v) const { return upOffsets[v]; }
+	int upEnd(int v) const { return upOffsets[v + 1]; }
+	int downBegin(int v) const { return downOffsets[v]; }
+	int downEnd(int v) const { return downOffsets[v + 1]; }
+	int getUpHead(int arc) const { return upHeads[arc]; }
+	int getUpWeight(int arc) const { return upWeights[arc]; }
+	int getDownTail(int arc) const { return downTails[arc]; }
+	int getDownWeight(int arc) const { return downWeights[arc]; }
+
+private:
+	void unpackArc(int from, int to, int middle, std::vector<int> &out) const;
+
+	Metric metric;
+	std::vector<int> rank;
+	std::vector<int> order;
+
+	std::vector<int> upOffsets, upHeads, upWeights, upMiddles;
+	std::vector<int> downOffsets, downTails, downWeights, downMiddles;
+};
+
+#endif //CONTRACTIONHIERARCHY_H
@@ -1,4 +1,5 @@
 #include "dataParser.h"
+#include "trace.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -6,6 +7,7 @@
 
 
 std::vector<Location> parseLocations(const std::string& filename) {
+	TraceSpan span("parseLocations");
 	std::vector<Location> locations;
 	std::ifstream file(filename);
 
@@ -51,6 +53,7 @@ std::vector<Location> parseLocations(const std::string& filename) {
 
 
 std::vector<Distance> parseDistances(const std::string& filename) {
+	TraceSpan span("parseDistances");
 	std::vector<Distance> distances;
 	std::ifstream file(filename);
 
@@ -98,7 +101,55 @@ std::vector<Distance> parseDistances(const std::string& filename) {
 }
 
 
+std::vector<Turn> parseTurns(const std::string& filename) {
+	TraceSpan span("parseTurns");
+	std::vector<Turn> turns;
+	std::ifstream file(filename);
+
+	if (!file.is_open()) {
+		std::cerr << "Error: Could not open file: " << filename << std::endl;
+		return turns;
+	}
+
+	std::string line;
+	bool firstLine = true;
+
+	while (std::getline(file, line)) {
+		if (firstLine) {
+			firstLine = false;
+			continue;
+		}
+
+		std::stringstream ss(line);
+		std::string token;
+		Turn turn;
+
+		// Parse the locations
+		std::getline(ss, turn.from, ',');
+		std::getline(ss, turn.via, ',');
+		std::getline(ss, turn.to, ',');
+
+		// Parse the penalty
+		std::getline(ss, token, ',');
+		if (token.empty()) {
+			continue;
+		}
+		if (token[0] == 'X') {
+			turn.penalty = INT_MAX;
+		}else {
+			turn.penalty = std::stoi(token);
+		}
+
+		turns.push_back(turn);
+	}
+
+	file.close();
+	return turns;
+}
+
+
 void fileToGraph(Graph * graph, const std::string& locationFilename, const std::string& distanceFilename) {
+	TraceSpan span("fileToGraph");
 	std::vector<Location> locations = parseLocations(locationFilename);
 	std::vector<Distance> distances = parseDistances(distanceFilename);
 
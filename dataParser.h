@@ -32,6 +32,16 @@ struct Distance{
 	int walking;
 };
 
+/**
+ * @brief Represents a turn rule: the extra time of going from one location through another to a third.
+ */
+struct Turn{
+	std::string from;
+	std::string via;
+	std::string to;
+	int penalty;
+};
+
 /**
  * @brief Parses a CSV file containing location data.
  *
@@ -54,6 +64,17 @@ std::vector<Location> parseLocations(const std::string& filename);
  */
 std::vector<Distance> parseDistances(const std::string& filename);
 
+/**
+ * @brief Parses a CSV file containing turn rules.
+ *
+ * Each line after the header is `From,Via,To,Penalty`, with location codes; a penalty of `X` bans the turn
+ * (INT_MAX). The time complexity is O(t), where t is the number of lines in the input file.
+ *
+ * @param filename The path to the turns CSV file.
+ * @return A vector of `Turn` objects, empty if the file could not be opened.
+ */
+std::vector<Turn> parseTurns(const std::string& filename);
+
 /**
  * @brief Fills the graph with vertices and edges based on location and distance data.
  *
@@ -0,0 +1,33 @@
+#include "deadline.h"
+
+namespace {
+
+thread_local QueryDeadline *current = nullptr;
+
+}
+
+QueryDeadline::QueryDeadline(long budgetMs) : bounded(budgetMs >= 0),
+	deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs < 0 ? 0 : budgetMs)) {}
+
+void QueryDeadline::cancel() {
+	cancelled.store(true, std::memory_order_relaxed);
+}
+
+bool QueryDeadline::expired() const {
+	return cancelled.load(std::memory_order_relaxed)
+		|| (bounded && std::chrono::steady_clock::now() >= deadline)
+		|| (enclosing != nullptr && enclosing->expired());
+}
+
+DeadlineScope::DeadlineScope(QueryDeadline &deadline) : previous(current) {
+	deadline.enclosing = previous;
+	current = &deadline;
+}
+
+DeadlineScope::~DeadlineScope() {
+	current = previous;
+}
+
+bool queryInterrupted() {
+	return current != nullptr && current->expired();
+}
@@ -0,0 +1,88 @@
+/**
+* @file deadline.h
+ * @brief Per-query deadlines and cooperative cancellation of the searches.
+ */
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+
+// Edge relaxations between two deadline checks in a search loop, so the clock is read rarely
+const int DEADLINE_CHECK_INTERVAL = 1024;
+
+/**
+ * @brief Deadline of a query, which another thread may also cancel.
+ *
+ * A deadline is made current on a thread with a DeadlineScope. The searches run on that thread poll it every
+ * DEADLINE_CHECK_INTERVAL relaxations (see DeadlinePoll) and stop early once it has expired; their results are then
+ * marked as timed out. A deadline made current inside another one also expires with it.
+ */
+class QueryDeadline {
+public:
+	/**
+	 * @brief Creates a deadline some time from now.
+	 *
+	 * @param budgetMs The time allowed to the query, in milliseconds; negative for none (it can still be cancelled).
+	 */
+	explicit QueryDeadline(long budgetMs = -1);
+
+	QueryDeadline(const QueryDeadline &) = delete;
+	QueryDeadline &operator=(const QueryDeadline &) = delete;
+
+	/**
+	 * @brief Cancels the query. Safe to call from any thread.
+	 */
+	void cancel();
+
+	/**
+	 * @brief Tells whether the query was cancelled or ran out of time. Once true, it stays true.
+	 */
+	bool expired() const;
+
+private:
+	friend class DeadlineScope;
+
+	std::atomic<bool> cancelled{false};
+	bool bounded;
+	std::chrono::steady_clock::time_point deadline;
+	const QueryDeadline *enclosing = nullptr;
+};
+
+/**
+ * @brief Makes a deadline current on this thread while the scope lasts.
+ */
+class DeadlineScope {
+public:
+	explicit DeadlineScope(QueryDeadline &deadline);
+	~DeadlineScope();
+
+	DeadlineScope(const DeadlineScope &) = delete;
+	DeadlineScope &operator=(const DeadlineScope &) = delete;
+
+private:
+	QueryDeadline *previous;
+};
+
+/**
+ * @brief Tells whether the current deadline of this thread has expired; false when there is none.
+ */
+bool queryInterrupted();
+
+/**
+ * @brief Countdown that checks the current deadline once every DEADLINE_CHECK_INTERVAL calls.
+ */
+struct DeadlinePoll {
+	int countdown = DEADLINE_CHECK_INTERVAL;
+
+	bool operator()() {
+		if (--countdown > 0) {
+			return false;
+		}
+		countdown = DEADLINE_CHECK_INTERVAL;
+		return queryInterrupted();
+	}
+};
+
+#endif //DEADLINE_H
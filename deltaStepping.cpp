@@ -0,0 +1,210 @@
+#include "deltaStepping.h"
+#include "deadline.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+
+namespace {
+
+// Tentative distances are packed with the number of edges of their path, as (dist << 32) | hops. Packed values order
+// by distance and then by hops, so among paths of equal time the one with fewer edges wins; the parents picked at the
+// end come from a vertex one hop closer to the source, which keeps the tree acyclic across zero-weight segments.
+
+const long UNREACHED = (long)INT_MAX << 32;
+
+long pack(long dist, long hops) {
+	return dist << 32 | hops;
+}
+
+long distOf(long label) {
+	return label >> 32;
+}
+
+long hopsOf(long label) {
+	return label & 0xffffffff;
+}
+
+// State of one delta-stepping search, shared by the pool workers
+
+struct DeltaSteppingState {
+	std::unique_ptr<std::atomic<long>[]> dist;
+	std::unique_ptr<std::atomic<unsigned>[]> stamp;
+	// buckets[worker][bucket] holds the vertices a worker moved into a bucket (may contain stale entries)
+	std::vector<std::vector<std::vector<int>>> buckets;
+	std::vector<std::vector<int>> settled;
+};
+
+template <int (Edge::*Weight)() const>
+int averageWeight(const std::vector<Vertex *> &vertices) {
+	long long sum = 0, count = 0;
+
+	for (auto v : vertices) {
+		for (auto e : v->getAdj()) {
+			int w = (e->*Weight)();
+			if (w < INT_MAX) {
+				sum += w;
+				count++;
+			}
+		}
+	}
+
+	return count == 0 ? 1 : std::max(1LL, sum / count);
+}
+
+template <int (Edge::*Weight)() const>
+void deltaStepping(Graph *graph, int source, int delta, WorkerPool &pool) {
+	TraceSpan span("deltaStepping");
+	Vertex *src = graph->findVertexById(source);
+
+	if (!src) {
+		return;
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	size_t n = vertices.size();
+	unsigned workers = pool.size();
+
+	if (delta <= 0) {
+		delta = averageWeight<Weight>(vertices);
+	}
+
+	DeltaSteppingState s;
+	s.dist.reset(new std::atomic<long>[n]);
+	s.stamp.reset(new std::atomic<unsigned>[n]);
+	s.buckets.resize(workers);
+	s.settled.resize(workers);
+
+	pool.run(n, [&](size_t begin, size_t end, unsigned) {
+		for (size_t i = begin; i < end; i++) {
+			s.dist[i].store(UNREACHED, std::memory_order_relaxed);
+			s.stamp[i].store(0, std::memory_order_relaxed);
+		}
+	});
+
+	s.dist[src->getIndex()] = pack(0, 0);
+	s.buckets[0].resize(1);
+	s.buckets[0][0].push_back(src->getIndex());
+
+	unsigned phase = 0;
+	std::vector<int> frontier;
+
+	// Relaxes the light or heavy edges of the vertices in the frontier, moving improved vertices to their bucket
+	auto relax = [&](bool light, size_t bucket) {
+		phase++;
+		pool.run(frontier.size(), [&](size_t begin, size_t end, unsigned worker) {
+			auto &local = s.buckets[worker];
+
+			for (size_t i = begin; i < end; i++) {
+				int v = frontier[i];
+				long label = s.dist[v].load(std::memory_order_relaxed);
+				long dv = distOf(label);
+
+				// Skip stale bucket entries and duplicates within this phase
+				if (dv / delta != (long)bucket || s.stamp[v].exchange(phase, std::memory_order_relaxed) == phase) {
+					continue;
+				}
+				if (light) {
+					s.settled[worker].push_back(v);
+				}
+
+				for (auto e : vertices[v]->getAdj()) {
+					int w = (e->*Weight)();
+					if (w == INT_MAX || (w <= delta) != light) {
+						continue;
+					}
+
+					// Times from INT_MAX on do not fit the label, and count as unreachable as in Dijkstra
+					if (dv + w >= INT_MAX) {
+						continue;
+					}
+
+					int u = e->getDest()->getIndex();
+					long nd = pack(dv + w, hopsOf(label) + 1);
+					long cur = s.dist[u].load(std::memory_order_relaxed);
+
+					while (nd < cur) {
+						if (s.dist[u].compare_exchange_weak(cur, nd, std::memory_order_relaxed)) {
+							size_t b = distOf(nd) / delta;
+							if (local.size() <= b) {
+								local.resize(b + 1);
+							}
+							local[b].push_back(u);
+							break;
+						}
+					}
+				}
+			}
+		}, 64);
+	};
+
+	// The deadline is checked once per bucket, on the calling thread
+	for (size_t bucket = 0; !queryInterrupted(); bucket++) {
+		bool remaining = false;
+		for (auto &local : s.buckets) {
+			remaining = remaining || local.size() > bucket;
+		}
+		if (!remaining) {
+			break;
+		}
+
+		// Light edges may move vertices back into the current bucket, so repeat until it is empty
+		while (true) {
+			frontier.clear();
+			for (auto &local : s.buckets) {
+				if (local.size() > bucket) {
+					frontier.insert(frontier.end(), local[bucket].begin(), local[bucket].end());
+					local[bucket].clear();
+				}
+			}
+			if (frontier.empty()) {
+				break;
+			}
+			relax(true, bucket);
+		}
+
+		// Distances in this bucket are now final, relax the heavy edges of the vertices settled in it
+		frontier.clear();
+		for (auto &settled : s.settled) {
+			frontier.insert(frontier.end(), settled.begin(), settled.end());
+			settled.clear();
+		}
+		relax(false, bucket);
+	}
+
+	// Write the distances back and pick, for each vertex, the tight incoming edge from a vertex one hop closer to the
+	// source, the one with the lowest index if there are several, so the tree does not depend on thread scheduling
+	pool.run(n, [&](size_t begin, size_t end, unsigned) {
+		for (size_t i = begin; i < end; i++) {
+			Vertex *v = vertices[i];
+			long label = s.dist[i].load(std::memory_order_relaxed);
+			long dv = distOf(label);
+			Edge *path = nullptr;
+
+			if (label != UNREACHED && v != src) {
+				for (auto e : v->getIncoming()) {
+					int w = (e->*Weight)();
+					long parent = s.dist[e->getOrig()->getIndex()].load(std::memory_order_relaxed);
+					if (w != INT_MAX && distOf(parent) + w == dv && hopsOf(parent) + 1 == hopsOf(label)
+						&& (path == nullptr || e->getOrig()->getIndex() < path->getOrig()->getIndex())) {
+						path = e;
+					}
+				}
+			}
+
+			v->setDist(dv);
+			v->setVisited(dv != INT_MAX);
+			v->setPath(path);
+		}
+	});
+}
+
+}
+
+void deltaSteppingDriving(Graph *graph, int source, int delta, WorkerPool &pool) {
+	deltaStepping<&Edge::getDriving>(graph, source, delta, pool);
+}
+
+void deltaSteppingWalking(Graph *graph, int source, int delta, WorkerPool &pool) {
+	deltaStepping<&Edge::getWalking>(graph, source, delta, pool);
+}
@@ -0,0 +1,53 @@
+/**
+* @file deltaStepping.h
+ * @brief Parallel delta-stepping single source shortest paths for the driving and walking metrics.
+ */
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include "Graph.h"
+#include "workerPool.h"
+
+/**
+ * @brief Number of vertices from which the one-to-all searches of the route planner switch from
+ *        Dijkstra to delta-stepping (when more than one hardware thread is available).
+ */
+const int DELTA_STEPPING_MIN_VERTICES = 20000;
+
+/**
+ * @brief Computes the shortest driving paths from the source to every vertex using parallel delta-stepping.
+ *
+ * Vertices are kept in buckets of width delta according to their tentative distance. The buckets are
+ * processed in increasing order; inside a bucket the light edges (weight <= delta) are relaxed in parallel
+ * until the bucket stops changing, and then the heavy edges of the settled vertices are relaxed once.
+ *
+ * The results are written to the vertices exactly like dijkstraDriving does: `dist` holds the distance
+ * (INT_MAX if unreachable), `visited` marks reached vertices and `path` the parent edge. Among paths of equal
+ * time the one with the fewest edges is kept, and the parent is a tight incoming edge from a vertex one edge
+ * closer to the source (the lowest index among several), so the tree has no cycles, even with zero-weight
+ * segments, and does not depend on thread scheduling.
+ *
+ * The work is O(V + E) per bucket phase plus re-relaxations, spread over the pool threads. The search stops
+ * between two buckets when the current query deadline expires (see deadline.h).
+ *
+ * @param graph The graph on which the search will be applied.
+ * @param source The ID of the source node.
+ * @param delta The bucket width; 0 uses the average edge weight.
+ * @param pool The threads used to relax the edges.
+ */
+void deltaSteppingDriving(Graph *graph, int source, int delta = 0, WorkerPool &pool = WorkerPool::shared());
+
+/**
+ * @brief Computes the shortest walking paths from the source to every vertex using parallel delta-stepping.
+ *
+ * See deltaSteppingDriving(), the only difference is the edge weight used.
+ *
+ * @param graph The graph on which the search will be applied.
+ * @param source The ID of the source node.
+ * @param delta The bucket width; 0 uses the average edge weight.
+ * @param pool The threads used to relax the edges.
+ */
+void deltaSteppingWalking(Graph *graph, int source, int delta = 0, WorkerPool &pool = WorkerPool::shared());
+
+#endif //DELTASTEPPING_H
@@ -0,0 +1,101 @@
+#include "distanceTable.h"
+#include <climits>
+
+namespace {
+
+struct BucketEntry {
+	int col;
+	long dist;
+};
+
+int indexOf(const Graph *graph, int id) {
+	Vertex *v = graph->findVertexById(id);
+	return v ? v->getIndex() : -1;
+}
+
+}
+
+DistanceTable manyToMany(const ContractionHierarchy &hierarchy, const Graph *graph, const std::vector<int> &sources,
+						 const std::vector<int> &targets, bool withPaths, WorkerPool &pool) {
+	DistanceTable table;
+	table.sources = sources;
+	table.targets = targets;
+	table.dist.assign(sources.size() * targets.size(), INT_MAX);
+
+	int n = hierarchy.size();
+	std::vector<UpwardSearch> searches(pool.size(), UpwardSearch(n));
+
+	// Backward phase: the search spaces are collected in parallel and then scattered into the buckets
+	std::vector<std::vector<std::pair<int, long>>> spaces(targets.size());
+	pool.run(targets.size(), [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t col = begin; col < end; col++) {
+			int t = indexOf(graph, targets[col]);
+			if (t < 0) {
+				continue;
+			}
+			hierarchy.upwardSearch(t, true, searches[worker]);
+			for (int v : searches[worker].settled) {
+				spaces[col].emplace_back(v, searches[worker].dist[v]);
+			}
+		}
+	}, 16);
+
+	std::vector<std::vector<BucketEntry>> buckets(n);
+	for (size_t col = 0; col < targets.size(); col++) {
+		for (auto &entry : spaces[col]) {
+			buckets[entry.first].push_back({(int)col, entry.second});
+		}
+		spaces[col] = {};
+	}
+
+	// Forward phase: each row is owned by one worker
+	pool.run(sources.size(), [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t row = begin; row < end; row++) {
+			int s = indexOf(graph, sources[row]);
+			if (s < 0) {
+				continue;
+			}
+			hierarchy.upwardSearch(s, false, searches[worker]);
+			long *out = &table.dist[row * targets.size()];
+
+			for (int v : searches[worker].settled) {
+				long d = searches[worker].dist[v];
+				for (auto &entry : buckets[v]) {
+					if (d + entry.dist < out[entry.col]) {
+						out[entry.col] = d + entry.dist;
+					}
+				}
+			}
+		}
+	}, 16);
+
+	if (withPaths) {
+		const std::vector<Vertex *> &vertices = graph->getVertexSet();
+		table.routes.assign(table.dist.size(), {{}, 0, -1});
+
+		pool.run(table.dist.size(), [&](size_t begin, size_t end, unsigned) {
+			for (size_t cell = begin; cell < end; cell++) {
+				if (table.dist[cell] == INT_MAX) {
+					continue;
+				}
+				int s = indexOf(graph, sources[cell / targets.size()]);
+				int t = indexOf(graph, targets[cell % targets.size()]);
+
+				Route &route = table.routes[cell];
+				for (int v : hierarchy.path(s, t)) {
+					route.r.push_back(vertices[v]->getId());
+				}
+				route.length = route.r.size();
+				route.time = table.dist[cell];
+			}
+		}, 64);
+	}
+
+	return table;
+}
+
+DistanceTable distanceTable(const Graph *graph, Metric metric, const std::vector<int> &sources,
+							const std::vector<int> &targets, bool withPaths) {
+	ContractionHierarchy hierarchy(graph, metric);
+	return manyToMany(hierarchy, graph, sources, targets, withPaths);
+}
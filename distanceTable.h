@@ -0,0 +1,74 @@
+/**
+* @file distanceTable.h
+ * @brief Many-to-many distance tables, e.g. from vehicle positions to pickup points.
+ */
+
+#ifndef DISTANCETABLE_H
+#define DISTANCETABLE_H
+
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+#include "contractionHierarchy.h"
+#include "workerPool.h"
+
+/**
+ * @brief Distances (and optionally routes) from every source to every target.
+ *
+ * Sources and targets are location IDs. Entries are stored row by row, one row per source, and hold
+ * INT_MAX when the target cannot be reached (or the ID does not exist).
+ */
+struct DistanceTable {
+	std::vector<int> sources;
+	std::vector<int> targets;
+	std::vector<long> dist;
+	std::vector<Route> routes;
+
+	/**
+	 * @brief Distance from sources[row] to targets[col].
+	 */
+	long at(int row, int col) const { return dist[(size_t)row * targets.size() + col]; }
+
+	/**
+	 * @brief Route from sources[row] to targets[col], only available if paths were requested.
+	 */
+	const Route &routeAt(int row, int col) const { return routes[(size_t)row * targets.size() + col]; }
+};
+
+/**
+ * @brief Computes a many-to-many table with the bucket algorithm over a contraction hierarchy.
+ *
+ * A backward upward search is run from every target, leaving (target, distance) entries in a bucket at
+ * each vertex it settles. A forward upward search from every source then scans the buckets of the vertices
+ * it settles, so each entry is the minimum over the meeting vertices. Both phases run in parallel. The time
+ * complexity is O((N + M) S + B), where S is the size of an upward search space and B the bucket entries
+ * scanned, instead of N full Dijkstras.
+ *
+ * @param hierarchy The contraction hierarchy of the metric, built for the current state of the graph.
+ * @param graph The graph, used to translate IDs.
+ * @param sources The source location IDs.
+ * @param targets The target location IDs.
+ * @param withPaths If true, the route of every entry is also computed (with a point-to-point query each).
+ * @param pool The threads used to run the searches.
+ * @return The table.
+ */
+DistanceTable manyToMany(const ContractionHierarchy &hierarchy, const Graph *graph, const std::vector<int> &sources,
+						 const std::vector<int> &targets, bool withPaths = false, WorkerPool &pool = WorkerPool::shared());
+
+/**
+ * @brief Computes a many-to-many table for a metric, building the contraction hierarchy first.
+ *
+ * When several tables are needed for the same graph, build the ContractionHierarchy once and call
+ * manyToMany() instead.
+ *
+ * @param graph The graph, whose closures are taken into account.
+ * @param metric The weight to use.
+ * @param sources The source location IDs.
+ * @param targets The target location IDs.
+ * @param withPaths If true, the route of every entry is also computed.
+ * @return The table.
+ */
+DistanceTable distanceTable(const Graph *graph, Metric metric, const std::vector<int> &sources,
+							const std::vector<int> &targets, bool withPaths = false);
+
+#endif //DISTANCETABLE_H
@@ -0,0 +1,24 @@
+#include "graphSnapshot.h"
+#include <climits>
+
+GraphSnapshot makeSnapshot(const Graph *graph, Metric metric, bool reverse) {
+	GraphSnapshot snapshot;
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+
+	snapshot.offsets.reserve(vertices.size() + 1);
+	snapshot.offsets.push_back(0);
+
+	for (auto v : vertices) {
+		for (auto e : reverse ? v->getIncoming() : v->getAdj()) {
+			int w = e->getWeight(metric);
+			if (w == INT_MAX) {
+				continue;
+			}
+			snapshot.targets.push_back(reverse ? e->getOrig()->getIndex() : e->getDest()->getIndex());
+			snapshot.weights.push_back(w);
+		}
+		snapshot.offsets.push_back(snapshot.targets.size());
+	}
+
+	return snapshot;
+}
@@ -0,0 +1,39 @@
+/**
+* @file graphSnapshot.h
+ * @brief Read-only compressed sparse row copy of a graph, used by the index-based search algorithms.
+ */
+
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Compressed sparse row copy of the open edges of a graph for one metric.
+ *
+ * Vertices are identified by their dense index (Vertex::getIndex()). The edges leaving vertex v are
+ * stored in [offsets[v], offsets[v + 1]) of `targets` and `weights`. Segments that cannot be used with
+ * the metric (driving weight INT_MAX, loaded from an `X`) are left out.
+ */
+struct GraphSnapshot {
+	std::vector<int> offsets;
+	std::vector<int> targets;
+	std::vector<int> weights;
+
+	int numVertex() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+};
+
+/**
+ * @brief Builds the snapshot of the open edges of a graph.
+ *
+ * The time complexity is O(V + E).
+ *
+ * @param graph The graph to copy.
+ * @param metric The weight to store.
+ * @param reverse If true, the incoming edges are stored instead, for searches on the reversed graph.
+ * @return The snapshot.
+ */
+GraphSnapshot makeSnapshot(const Graph *graph, Metric metric, bool reverse = false);
+
+#endif //GRAPHSNAPSHOT_H
@@ -0,0 +1,228 @@
+#include "hubLabels.h"
+#include "contractionHierarchy.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+void writeVarint(uint32_t value, std::vector<uint8_t> &out) {
+	while (value >= 0x80) {
+		out.push_back((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out.push_back(value);
+}
+
+uint32_t readVarint(const uint8_t *&in) {
+	uint32_t value = 0;
+	for (int shift = 0; ; shift += 7) {
+		uint8_t byte = *in++;
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+}
+
+// A label is a sequence of (hub delta, distance) pairs, hubs increasing from 0
+
+void encodeLabel(const std::vector<std::pair<int, int>> &entries, std::vector<uint8_t> &out) {
+	int previous = 0;
+	for (auto &[hub, dist] : entries) {
+		writeVarint(hub - previous, out);
+		writeVarint(dist, out);
+		previous = hub;
+	}
+}
+
+template <typename Visit>
+void forEachEntry(const uint8_t *in, const uint8_t *end, Visit visit) {
+	for (uint32_t hub = 0; in != end; ) {
+		hub += readVarint(in);
+		visit(hub, readVarint(in));
+	}
+}
+
+// Merge of two labels: the smallest sum of distances over their common hubs, INT_MAX if there is none
+
+long mergeLabels(const uint8_t *a, const uint8_t *aEnd, const uint8_t *b, const uint8_t *bEnd) {
+	long best = INT_MAX;
+	if (a == aEnd || b == bEnd) {
+		return best;
+	}
+
+	uint32_t hubA = readVarint(a), distA = readVarint(a);
+	uint32_t hubB = readVarint(b), distB = readVarint(b);
+	while (true) {
+		if (hubA == hubB) {
+			best = std::min(best, (long)distA + distB);
+		}
+		if (hubA <= hubB) {
+			if (a == aEnd) {
+				break;
+			}
+			hubA += readVarint(a);
+			distA = readVarint(a);
+		}
+		else {
+			if (b == bEnd) {
+				break;
+			}
+			hubB += readVarint(b);
+			distB = readVarint(b);
+		}
+	}
+	return best;
+}
+
+}
+
+/*
+ * Vertices are labelled from the highest rank down. The candidates of a forward label are the vertex itself and,
+ * through each upward arc, the forward label of its head (already final, as the head ranks higher); a backward label
+ * is built in the same way through the arcs that arrive from higher vertices. A candidate distance to a hub is only
+ * an upper bound: it is kept when merging the candidates with the opposite label of the hub gives nothing shorter.
+ */
+
+HubLabels::HubLabels(const Graph *graph, Metric metric) : graph(graph) {
+	ContractionHierarchy hierarchy(graph, metric);
+	int n = hierarchy.size();
+	const std::vector<int> &order = hierarchy.getOrder();
+
+	std::vector<std::vector<uint8_t>> forward(n), backward(n);
+	std::vector<long> best(n, LONG_MAX);
+	std::vector<int> touched;
+	std::vector<std::pair<int, int>> candidates;
+	std::vector<uint8_t> encoded;
+
+	for (int i = n - 1; i >= 0; i--) {
+		int v = order[i];
+
+		for (bool isForward : {true, false}) {
+			std::vector<std::vector<uint8_t>> &labels = isForward ? forward : backward;
+			const std::vector<std::vector<uint8_t>> &opposite = isForward ? backward : forward;
+			int begin = isForward ? hierarchy.upBegin(v) : hierarchy.downBegin(v);
+			int end = isForward ? hierarchy.upEnd(v) : hierarchy.downEnd(v);
+
+			best[i] = 0;
+			touched.push_back(i);
+			for (int arc = begin; arc < end; arc++) {
+				int u = isForward ? hierarchy.getUpHead(arc) : hierarchy.getDownTail(arc);
+				int weight = isForward ? hierarchy.getUpWeight(arc) : hierarchy.getDownWeight(arc);
+				const std::vector<uint8_t> &label = labels[u];
+				forEachEntry(label.data(), label.data() + label.size(), [&](int hub, int dist) {
+					if (best[hub] == LONG_MAX) {
+						touched.push_back(hub);
+					}
+					best[hub] = std::min(best[hub], (long)weight + dist);
+				});
+			}
+
+			std::sort(touched.begin(), touched.end());
+			candidates.clear();
+			for (int hub : touched) {
+				candidates.emplace_back(hub, best[hub]);
+				best[hub] = LONG_MAX;
+			}
+			touched.clear();
+
+			encoded.clear();
+			encodeLabel(candidates, encoded);
+			std::vector<std::pair<int, int>> kept;
+			for (auto &[hub, dist] : candidates) {
+				const std::vector<uint8_t> &other = opposite[order[hub]];
+				if (hub == i || mergeLabels(encoded.data(), encoded.data() + encoded.size(), other.data(),
+											other.data() + other.size()) >= dist) {
+					kept.push_back({hub, dist});
+				}
+			}
+
+			encodeLabel(kept, labels[v]);
+			labels[v].shrink_to_fit();
+			numEntries += kept.size();
+		}
+	}
+
+	for (bool isForward : {true, false}) {
+		std::vector<std::vector<uint8_t>> &labels = isForward ? forward : backward;
+		std::vector<size_t> &offsets = isForward ? forwardOffsets : backwardOffsets;
+		std::vector<uint8_t> &bytes = isForward ? forwardBytes : backwardBytes;
+
+		offsets.push_back(0);
+		for (int v = 0; v < n; v++) {
+			bytes.insert(bytes.end(), labels[v].begin(), labels[v].end());
+			offsets.push_back(bytes.size());
+			std::vector<uint8_t>().swap(labels[v]);
+		}
+	}
+
+	arcOffsets.push_back(0);
+	for (auto v : graph->getVertexSet()) {
+		for (auto e : v->getAdj()) {
+			if (e->getWeight(metric) != INT_MAX) {
+				arcHeads.push_back(e->getDest()->getIndex());
+				arcWeights.push_back(e->getWeight(metric));
+			}
+		}
+		arcOffsets.push_back(arcHeads.size());
+	}
+}
+
+long HubLabels::distance(int source, int destination) const {
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+	if (src == nullptr || dest == nullptr) {
+		return INT_MAX;
+	}
+	return distanceByIndex(src->getIndex(), dest->getIndex());
+}
+
+long HubLabels::distanceByIndex(int source, int target) const {
+	return mergeLabels(forwardBytes.data() + forwardOffsets[source], forwardBytes.data() + forwardOffsets[source + 1],
+					   backwardBytes.data() + backwardOffsets[target], backwardBytes.data() + backwardOffsets[target + 1]);
+}
+
+Route HubLabels::route(int source, int destination) const {
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+	if (src == nullptr || dest == nullptr) {
+		return {{}, 0, -1};
+	}
+
+	int t = dest->getIndex();
+	long total = distanceByIndex(src->getIndex(), t);
+	if (total == INT_MAX) {
+		return {{}, 0, -1};
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	std::vector<int> route = {source};
+	long left = total;
+
+	// Each step settles one location for good, so a route has fewer steps than there are vertices
+	for (int v = src->getIndex(); v != t && route.size() <= vertices.size(); ) {
+		int next = -1;
+		for (int arc = arcOffsets[v]; arc < arcOffsets[v + 1] && next == -1; arc++) {
+			int u = arcHeads[arc];
+			if (arcWeights[arc] <= left && arcWeights[arc] + distanceByIndex(u, t) == left) {
+				next = u;
+				left -= arcWeights[arc];
+			}
+		}
+		if (next == -1) {
+			return {{}, 0, -1};
+		}
+		v = next;
+		route.push_back(vertices[v]->getId());
+	}
+
+	return {route, (int)route.size(), (int)total};
+}
+
+size_t HubLabels::getNumEntries() const {
+	return numEntries;
+}
+
+size_t HubLabels::memoryUsage() const {
+	return forwardBytes.size() + backwardBytes.size() + (forwardOffsets.size() + backwardOffsets.size()) * sizeof(size_t);
+}
@@ -0,0 +1,90 @@
+/**
+* @file hubLabels.h
+ * @brief Hub labeling: shortest distances read from two precomputed labels, without any search.
+ */
+
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+
+/**
+ * @brief Forward and backward hub labels of every vertex, built from a contraction hierarchy.
+ *
+ * The forward label of a vertex lists hubs with the distance from the vertex to each, the backward label hubs
+ * with the distance from each to the vertex. Every pair of vertices has a hub on one of its shortest paths in
+ * both labels, so the distance is the minimum, over the common hubs, of the two label distances. Labels are
+ * built top-down over the hierarchy: a vertex inherits the labels of its upward neighbours, and entries whose
+ * distance is longer than the one the labels already give are pruned.
+ *
+ * Hubs are numbered by rank and each label is sorted by hub, so a query is a single merge of two lists. A label
+ * is stored as a byte stream of variable-length hub deltas and distances, decoded during the merge, which takes
+ * about a third of the memory of plain (hub, distance) pairs.
+ */
+class HubLabels {
+public:
+	/**
+	 * @brief Builds the labels for a metric of a graph.
+	 *
+	 * The time complexity is that of the hierarchy plus O(V L^2), where L is the average label size.
+	 *
+	 * @param graph The graph, whose closures are taken into account. Later changes are not seen.
+	 * @param metric The weight to use.
+	 */
+	explicit HubLabels(const Graph *graph, Metric metric = Metric::Driving);
+
+	/**
+	 * @brief Shortest distance between two locations. O(L).
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @return The distance, or INT_MAX if there is no route or a location does not exist.
+	 */
+	long distance(int source, int destination) const;
+
+	/**
+	 * @brief Shortest distance between two vertices, by dense index. O(L).
+	 */
+	long distanceByIndex(int source, int target) const;
+
+	/**
+	 * @brief Best route between two locations, recovered with distance queries.
+	 *
+	 * From the source, the route follows at each step a segment that keeps the distance left to the destination
+	 * exact, so it costs O(P D L) for a route of P locations with degree D; no path data is stored.
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @return The route, with time -1 if there is none.
+	 */
+	Route route(int source, int destination) const;
+
+	/**
+	 * @brief Total number of label entries, forward and backward.
+	 */
+	size_t getNumEntries() const;
+
+	/**
+	 * @brief Memory used by the labels, in bytes.
+	 */
+	size_t memoryUsage() const;
+
+private:
+	const Graph *graph;
+	size_t numEntries = 0;
+
+	// Label of vertex v: bytes [offsets[v], offsets[v + 1]) of the stream, hubs by rank
+	std::vector<size_t> forwardOffsets, backwardOffsets;
+	std::vector<uint8_t> forwardBytes, backwardBytes;
+
+	// Original arcs, in compressed sparse row form, for route recovery
+	std::vector<int> arcOffsets;
+	std::vector<int> arcHeads;
+	std::vector<int> arcWeights;
+};
+
+#endif //HUBLABELS_H
@@ -0,0 +1,123 @@
+/**
+* @file hubLabelsBench.cpp
+ * @brief Reports the size, build time and query time of the hub labels (see hubLabels.h) on a map.
+ *
+ * Usage: `hubLabelsBench [--map dir | --grid side] [--metric driving|walking] [--queries N] [--seed S]`
+ *
+ * The map is a sample map directory (smallSampleSize by default) or a synthetic grid (see syntheticMap.h). The
+ * labels are built once, then the same random pairs are answered by HubLabels::distanceByIndex() and, for a
+ * twentieth of them, by the contraction hierarchy the labels are built on, for comparison. Route recovery is timed
+ * on a hundred pairs. Nothing is checked here; the hubLabels test compares the labels with Dijkstra.
+ */
+#include "Graph.h"
+#include "contractionHierarchy.h"
+#include "dataParser.h"
+#include "hubLabels.h"
+#include "syntheticMap.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+	std::string mapDir = "smallSampleSize";
+	int side = 0;
+	Metric metric = Metric::Driving;
+	int queries = 200000;
+	unsigned seed = 1;
+
+	for (int arg = 1; arg < argc; arg++) {
+		std::string option = argv[arg];
+
+		if (option == "--map" && arg + 1 < argc) {
+			mapDir = argv[++arg];
+		}
+		else if (option == "--grid" && arg + 1 < argc) {
+			side = std::max(1, std::stoi(argv[++arg]));
+		}
+		else if (option == "--metric" && arg + 1 < argc) {
+			metric = std::string(argv[++arg]) == "walking" ? Metric::Walking : Metric::Driving;
+		}
+		else if (option == "--queries" && arg + 1 < argc) {
+			queries = std::max(1, std::stoi(argv[++arg]));
+		}
+		else if (option == "--seed" && arg + 1 < argc) {
+			seed = std::stoul(argv[++arg]);
+		}
+		else {
+			std::cerr << "Usage: hubLabelsBench [--map dir | --grid side] [--metric driving|walking] [--queries N]"
+					  << " [--seed S]" << std::endl;
+			return 1;
+		}
+	}
+
+	Graph graph;
+	if (side > 0) {
+		syntheticGrid(&graph, side, seed);
+	}
+	else {
+		fileToGraph(&graph, mapDir + "/Locations.csv", mapDir + "/Distances.csv");
+	}
+	int n = graph.getNumVertex();
+	if (n == 0) {
+		std::cerr << "Empty map" << std::endl;
+		return 1;
+	}
+
+	Clock::time_point start = Clock::now();
+	HubLabels labels(&graph, metric);
+	double build = secondsSince(start);
+
+	std::mt19937 rng(seed);
+	std::vector<std::pair<int, int>> pairs(queries);
+	for (auto &pair : pairs) {
+		pair = {(int)(rng() % n), (int)(rng() % n)};
+	}
+
+	// The sum keeps the queries from being optimized away
+	long checksum = 0;
+	start = Clock::now();
+	for (auto &[source, target] : pairs) {
+		checksum += labels.distanceByIndex(source, target);
+	}
+	double labelQuery = secondsSince(start) / queries;
+
+	ContractionHierarchy hierarchy(&graph, metric);
+	int hierarchyQueries = std::max(1, queries / 20);
+	start = Clock::now();
+	for (int i = 0; i < hierarchyQueries; i++) {
+		checksum += hierarchy.distance(pairs[i].first, pairs[i].second);
+	}
+	double hierarchyQuery = secondsSince(start) / hierarchyQueries;
+
+	const std::vector<Vertex *> &vertices = graph.getVertexSet();
+	int routeQueries = std::min(queries, 100);
+	start = Clock::now();
+	for (int i = 0; i < routeQueries; i++) {
+		checksum += labels.route(vertices[pairs[i].first]->getId(), vertices[pairs[i].second]->getId()).time;
+	}
+	double routeQuery = secondsSince(start) / routeQueries;
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "Vertices: " << n << std::endl;
+	std::cout << "Build: " << build << " s" << std::endl;
+	std::cout << "Entries per label: " << (double)labels.getNumEntries() / n / 2 << std::endl;
+	std::cout << "Memory: " << labels.memoryUsage() / 1048576.0 << " MiB ("
+			  << (double)labels.memoryUsage() / std::max<size_t>(1, labels.getNumEntries()) << " bytes per entry)"
+			  << std::endl;
+	std::cout << "Label query: " << labelQuery * 1e6 << " us" << std::endl;
+	std::cout << "Hierarchy query: " << hierarchyQuery * 1e6 << " us" << std::endl;
+	std::cout << "Route recovery: " << routeQuery * 1e6 << " us" << std::endl;
+	std::cout << "Checksum: " << checksum << std::endl;
+	return 0;
+}
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 #include <regex>
+#include <algorithm>
 
 void parseInputStr(std::string& input, const std::string& output) {
 	std::cout << output;
@@ -44,26 +45,41 @@ void stringToVectorOfPair(const std::string& s, std::vector<std::pair<int, int>>
 }
 
 RoutePlan showRoutePlanningMenu() {
-	RoutePlan routePlan = {"", -1, -1, -1, {}, -1, {}};
+	RoutePlan routePlan = {"", -1, -1, -1, {}, {}, {}};
 	std::cout << "Write 'none' if you don't want to fill in the field\n\n";
 
 	std::string avoidNodesStr;
 	std::string avoidSegmentsStr;
+	std::string includeNodesStr = "none";
 
 	parseInputStr(routePlan.mode, "Mode:");
+	bool isochrone = routePlan.mode == "driving-isochrone" || routePlan.mode == "walking-isochrone";
+
 	parseInputInt(routePlan.source, "Source:");
-	parseInputInt(routePlan.destination, "Destination:");
-	if (routePlan.mode != "driving") {
+	if (isochrone) {
+		parseInputInt(routePlan.maxTime, "MaxTime:");
+	}
+	else if (routePlan.mode != "driving-accessibility") {
+		parseInputInt(routePlan.destination, "Destination:");
+	}
+	if (routePlan.mode == "driving-walking" || routePlan.mode == "driving-walking-pareto") {
 		parseInputInt(routePlan.maxWalkTime, "MaxWalkTime:");
 	}
 	parseInputStr(avoidNodesStr, "AvoidNodes:");
 	parseInputStr(avoidSegmentsStr, "AvoidSegments:");
-	if (routePlan.mode != "driving-walking") {
-		parseInputInt(routePlan.includeNode, "IncludeNode:");
+	if (routePlan.mode == "driving") {
+		parseInputStr(includeNodesStr, "IncludeNode:");
 	}
 
 	stringToVector(avoidNodesStr, routePlan.avoidNodes);
 	stringToVectorOfPair(avoidSegmentsStr, routePlan.avoidSegments);
+	stringToVector(includeNodesStr, routePlan.includeNodes);
+
+	if (routePlan.includeNodes.size() > 1) {
+		std::string includeOrder;
+		parseInputStr(includeOrder, "IncludeOrder:");
+		routePlan.includeBestOrder = includeOrder == "best";
+	}
 
 	std::cout << std::endl;
 
@@ -73,7 +89,7 @@ RoutePlan showRoutePlanningMenu() {
 
 RoutePlan fileRoutePlan() {
 
-	RoutePlan routePlan = {"", -1, -1, -1, {}, -1, {}};
+	RoutePlan routePlan = {"", -1, -1, -1, {}, {}, {}};
 
 	std::ifstream file("input_output/input.txt");
 
@@ -90,28 +106,133 @@ RoutePlan fileRoutePlan() {
 		std::getline(ss, key, ':');
 		std::getline(ss, value);
 
-		if (value.empty()) {
+		parseRoutePlanField(routePlan, key, value);
+	}
+
+	file.close();
+
+	return routePlan;
+}
+
+
+std::vector<RoutePlan> fileRoutePlans(const std::string& filename) {
+	std::vector<RoutePlan> routePlans;
+
+	std::ifstream file(filename);
+
+	if (!file.is_open()) {
+		std::cerr << "Error: Could not open file: " << filename << std::endl;
+		return routePlans;
+	}
+
+	std::string line;
+	bool inPlan = false;
+
+	while (std::getline(file, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+
+		// A blank line ends the current plan
+		if (line.empty()) {
+			inPlan = false;
 			continue;
 		}
 
-		if (key == "Mode") {
-			routePlan.mode = value;
-		} else if (key == "Source") {
-			routePlan.source = std::stoi(value);
-		} else if (key == "Destination") {
-			routePlan.destination = std::stoi(value);
-		} else if (key == "MaxWalkTime") {
-			routePlan.maxWalkTime = std::stoi(value);
-		} else if (key == "AvoidNodes") {
-			stringToVector(value, routePlan.avoidNodes);
-		} else if (key == "AvoidSegments") {
-			stringToVectorOfPair(value, routePlan.avoidSegments);
-		} else if (key == "IncludeNode") {
-			routePlan.includeNode = std::stoi(value);
+		if (!inPlan) {
+			routePlans.push_back({"", -1, -1, -1, {}, {}, {}});
+			inPlan = true;
 		}
+
+		std::stringstream ss(line);
+		std::string key, value;
+		std::getline(ss, key, ':');
+		std::getline(ss, value);
+
+		parseRoutePlanField(routePlans.back(), key, value);
 	}
 
 	file.close();
 
-	return routePlan;
+	return routePlans;
+}
+
+
+void parseRoutePlanField(RoutePlan& routePlan, const std::string& key, const std::string& value) {
+	if (value.empty()) {
+		return;
+	}
+
+	if (key == "Mode") {
+		routePlan.mode = value;
+	} else if (key == "Source") {
+		routePlan.source = std::stoi(value);
+	} else if (key == "Destination") {
+		routePlan.destination = std::stoi(value);
+	} else if (key == "MaxWalkTime") {
+		routePlan.maxWalkTime = std::stoi(value);
+	} else if (key == "MaxTime") {
+		routePlan.maxTime = std::stoi(value);
+	} else if (key == "AvoidNodes") {
+		stringToVector(value, routePlan.avoidNodes);
+	} else if (key == "AvoidSegments") {
+		stringToVectorOfPair(value, routePlan.avoidSegments);
+	} else if (key == "IncludeNode") {
+		stringToVector(value, routePlan.includeNodes);
+	} else if (key == "IncludeOrder") {
+		routePlan.includeBestOrder = value == "best";
+	} else if (key == "Suboptimality") {
+		routePlan.suboptimality = std::max(1.0, std::stod(value));
+	} else if (key == "Deadline") {
+		routePlan.deadline = std::stoi(value);
+	}
+}
+
+
+void writeRoutePlan(const RoutePlan& routePlan, std::ostream& out, char separator) {
+	out << "Mode:" << routePlan.mode << separator;
+	out << "Source:" << routePlan.source << separator;
+
+	if (routePlan.destination != -1) {
+		out << "Destination:" << routePlan.destination << separator;
+	}
+	if (routePlan.maxWalkTime != -1) {
+		out << "MaxWalkTime:" << routePlan.maxWalkTime << separator;
+	}
+	if (routePlan.maxTime != -1) {
+		out << "MaxTime:" << routePlan.maxTime << separator;
+	}
+
+	if (!routePlan.avoidNodes.empty()) {
+		out << "AvoidNodes:";
+		for (size_t i = 0; i < routePlan.avoidNodes.size(); i++) {
+			out << (i > 0 ? "," : "") << routePlan.avoidNodes[i];
+		}
+		out << separator;
+	}
+	if (!routePlan.avoidSegments.empty()) {
+		out << "AvoidSegments:";
+		for (size_t i = 0; i < routePlan.avoidSegments.size(); i++) {
+			out << (i > 0 ? "," : "") << "(" << routePlan.avoidSegments[i].first << ","
+				<< routePlan.avoidSegments[i].second << ")";
+		}
+		out << separator;
+	}
+	if (!routePlan.includeNodes.empty()) {
+		out << "IncludeNode:";
+		for (size_t i = 0; i < routePlan.includeNodes.size(); i++) {
+			out << (i > 0 ? "," : "") << routePlan.includeNodes[i];
+		}
+		out << separator;
+	}
+
+	if (routePlan.includeBestOrder) {
+		out << "IncludeOrder:best" << separator;
+	}
+	if (routePlan.suboptimality > 1) {
+		out << "Suboptimality:" << routePlan.suboptimality << separator;
+	}
+	if (routePlan.deadline >= 0) {
+		out << "Deadline:" << routePlan.deadline << separator;
+	}
 }
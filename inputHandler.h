@@ -17,6 +17,18 @@
  *
  * This structure holds all the necessary information for a route plan, including the mode of transportation,
  * source and destination locations, maximum walking time, nodes to avoid, and segments to avoid.
+ *
+ * A driving route goes through every node of includeNodes (`IncludeNode:3,7,2`), in the given order, or in the
+ * order that minimizes the total time if includeBestOrder is set (`IncludeOrder:best`).
+ *
+ * The "driving-isochrone" and "walking-isochrone" modes ask for every location reachable from the source
+ * within maxTime minutes, and ignore the destination.
+ *
+ * A driving route may be up to suboptimality times longer than the best one (`Suboptimality:1.05`) in exchange
+ * for a faster search; the output then reports the bound of each route.
+ *
+ * A plan may be given a deadline in milliseconds (`Deadline:50`): searches still running when it expires stop,
+ * and their routes are reported as `timeout`.
  */
 struct RoutePlan {
 	std::string mode;
@@ -24,8 +36,12 @@ struct RoutePlan {
 	int destination;
 	int maxWalkTime;
 	std::vector<int> avoidNodes;
-	int includeNode;
+	std::vector<int> includeNodes;
 	std::vector<std::pair<int, int>> avoidSegments;
+	int maxTime = -1;
+	bool includeBestOrder = false;
+	double suboptimality = 1;
+	int deadline = -1;
 };
 
 /**
@@ -48,6 +64,36 @@ RoutePlan showRoutePlanningMenu();
  */
 RoutePlan fileRoutePlan();
 
+/**
+ * @brief Reads a batch of route plans from an input file.
+ *
+ * The file holds several route plans in the same format as `input.txt`, separated by blank lines.
+ *
+ * @param filename The path to the batch input file.
+ * @return std::vector<RoutePlan> The route plans, in file order.
+ */
+std::vector<RoutePlan> fileRoutePlans(const std::string& filename);
+
+/**
+ * @brief Applies one `Key:value` line of a route plan file to a route plan.
+ *
+ * @param routePlan The route plan being read.
+ * @param key The field name.
+ * @param value The field value (lines with an empty value are ignored).
+ */
+void parseRoutePlanField(RoutePlan& routePlan, const std::string& key, const std::string& value);
+
+/**
+ * @brief Writes a route plan as `Key:value` fields, the inverse of parseRoutePlanField().
+ *
+ * Fields left at their default are omitted. With '\n' as separator the output is an `input.txt` file.
+ *
+ * @param routePlan The route plan.
+ * @param out The output stream to write to.
+ * @param separator The character written after each field.
+ */
+void writeRoutePlan(const RoutePlan& routePlan, std::ostream& out, char separator);
+
 /**
  * @brief Parses a string input from the user.
  *
@@ -0,0 +1,80 @@
+#include "isochrone.h"
+#include "searchKernel.h"
+#include "trace.h"
+#include <algorithm>
+
+namespace {
+
+// Records the settled vertices with their time
+
+struct ReachableRecorder {
+	const std::vector<Vertex *> &vertices;
+	Isochrone &result;
+
+	void settled(int v, long dist, const Edge *) { result.reachable.emplace_back(vertices[v]->getId(), dist); }
+};
+
+// The search buffers belong to a worker; only the touched entries are reset between searches
+
+Isochrone boundedSearch(const Graph *graph, Metric metric, int origin, int maxTime, SearchBuffers<> &search) {
+	TraceSpan span("isochroneSearch");
+	Isochrone result = {origin, maxTime, {}};
+	Vertex *src = graph->findVertexById(origin);
+
+	if (!src || maxTime < 0) {
+		return result;
+	}
+
+	// Only vertices within maxTime are ever queued, so the search ends with the isochrone complete
+	search.start(src->getIndex());
+	ReachableRecorder recorder{graph->getVertexSet(), result};
+	bool complete = metric == Metric::Driving
+		? searchKernel<DrivingWeight>(graph, search, WithinBound{maxTime}, Exhaustive(), recorder)
+		: searchKernel<WalkingWeight>(graph, search, WithinBound{maxTime}, Exhaustive(), recorder);
+	if (!complete) {
+		result.reachable.clear();
+	}
+
+	std::sort(result.reachable.begin(), result.reachable.end(), [](auto &a, auto &b) {
+		return a.second != b.second ? a.second < b.second : a.first < b.first;
+	});
+	return result;
+}
+
+}
+
+Isochrone isochrone(const Graph *graph, Metric metric, int origin, int maxTime) {
+	SearchBuffers<> search(graph->getNumVertex());
+	return boundedSearch(graph, metric, origin, maxTime, search);
+}
+
+std::vector<Isochrone> isochrones(const Graph *graph, Metric metric, const std::vector<int> &origins, int maxTime,
+								  WorkerPool &pool) {
+	std::vector<Isochrone> result(origins.size());
+	std::vector<SearchBuffers<>> searches(pool.size(), SearchBuffers<>(graph->getNumVertex()));
+
+	pool.run(origins.size(), [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t i = begin; i < end; i++) {
+			result[i] = boundedSearch(graph, metric, origins[i], maxTime, searches[worker]);
+		}
+	}, 1);
+
+	return result;
+}
+
+void printIsochrone(const Isochrone &isochrone, std::ostream &out) {
+	out << "ReachableLocations:";
+
+	if (isochrone.reachable.empty()) {
+		out << "none" << std::endl;
+		return;
+	}
+
+	for (size_t i = 0; i < isochrone.reachable.size(); i++) {
+		if (i > 0) {
+			out << ",";
+		}
+		out << isochrone.reachable[i].first << "(" << isochrone.reachable[i].second << ")";
+	}
+	out << std::endl;
+}
@@ -0,0 +1,68 @@
+/**
+* @file isochrone.h
+ * @brief Reachability queries: every location reachable within a time limit, by car or on foot.
+ */
+
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "workerPool.h"
+
+/**
+ * @struct Isochrone
+ * @brief Locations reachable from an origin within a time limit.
+ *
+ * `reachable` holds (location ID, time) pairs sorted by time and then by ID, starting with the origin itself.
+ * It is empty if the origin does not exist.
+ */
+struct Isochrone {
+	int origin;
+	int maxTime;
+	std::vector<std::pair<int, int>> reachable;
+};
+
+/**
+ * @brief Computes the locations reachable from an origin within a time limit.
+ *
+ * Runs a Dijkstra that stops as soon as the next vertex is farther than the limit, so only the vertices
+ * inside the isochrone (and their neighbours) are touched. The time complexity is O((R + E_R) log R), where
+ * R is the number of reachable vertices and E_R the edges leaving them. Closed locations and segments are
+ * taken into account. A search stopped by the query deadline returns no locations; queryInterrupted() tells it
+ * apart from an origin that does not exist.
+ *
+ * @param graph The graph.
+ * @param metric The weight to use (driving or walking time).
+ * @param origin The ID of the origin.
+ * @param maxTime The time limit.
+ * @return The isochrone.
+ */
+Isochrone isochrone(const Graph *graph, Metric metric, int origin, int maxTime);
+
+/**
+ * @brief Computes the isochrones of many origins in parallel.
+ *
+ * The graph is only read, each worker uses its own search buffers.
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param origins The IDs of the origins.
+ * @param maxTime The time limit, the same for every origin.
+ * @param pool The threads used to run the searches.
+ * @return One isochrone per origin, in the same order.
+ */
+std::vector<Isochrone> isochrones(const Graph *graph, Metric metric, const std::vector<int> &origins, int maxTime,
+								  WorkerPool &pool = WorkerPool::shared());
+
+/**
+ * @brief Prints an isochrone as `ReachableLocations:id(time),...`, or `none` if the origin does not exist.
+ *
+ * @param isochrone The isochrone to be printed.
+ * @param out The output stream to print to.
+ */
+void printIsochrone(const Isochrone &isochrone, std::ostream &out);
+
+#endif //ISOCHRONE_H
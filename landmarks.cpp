@@ -0,0 +1,107 @@
+#include "landmarks.h"
+#include "searchKernel.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+LandmarkIndex::LandmarkIndex(Graph *graph, int count) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int n = vertices.size();
+	std::vector<std::vector<int>> columns;
+
+	// nearest[v] is the time to v from the closest landmark picked so far, LONG_MAX while no landmark reaches it
+	std::vector<long> nearest(n, LONG_MAX);
+	int next = 0;
+
+	while (n > 0 && (int)columns.size() < count && nearest[next] != 0) {
+		dijkstraSearch<DrivingWeight>(graph, vertices[next]->getId());
+
+		columns.emplace_back(n);
+		for (int v = 0; v < n; v++) {
+			int d = vertices[v]->getDist();
+			columns.back()[v] = d;
+			if (d != INT_MAX) {
+				nearest[v] = std::min(nearest[v], (long)d);
+			}
+		}
+
+		// Unreached vertices count as the farthest, so every component gets a landmark before any gets two
+		for (int v = 0; v < n; v++) {
+			if (!vertices[v]->isClosed() && nearest[v] > nearest[next]) {
+				next = v;
+			}
+		}
+	}
+
+	this->count = columns.size();
+	dist.resize((size_t)n * this->count);
+	for (int v = 0; v < n; v++) {
+		for (int l = 0; l < this->count; l++) {
+			dist[(size_t)v * this->count + l] = columns[l][v];
+		}
+	}
+}
+
+long LandmarkIndex::lowerBound(int from, int to) const {
+	const int *a = dist.data() + (size_t)from * count;
+	const int *b = dist.data() + (size_t)to * count;
+	long bound = 0;
+	for (int l = 0; l < count; l++) {
+		if (a[l] != INT_MAX && b[l] != INT_MAX) {
+			bound = std::max(bound, std::abs((long)b[l] - a[l]));
+		}
+	}
+	return bound;
+}
+
+int LandmarkIndex::getNumLandmarks() const {
+	return count;
+}
+
+void precomputeLandmarks(Graph *graph, int count) {
+	graph->setLandmarks(new LandmarkIndex(graph, count));
+}
+
+namespace {
+
+// Weighted lower bound on the driving time left to the target, the potential of the A* search
+
+struct LandmarkPotential {
+	const LandmarkIndex *landmarks;
+	int target;
+	double factor;
+
+	double operator()(int v) const { return landmarks == nullptr ? 0 : factor * landmarks->lowerBound(v, target); }
+};
+
+}
+
+Route boundedDrivingRoute(Graph *graph, int source, int destination, double factor) {
+	TraceSpan span("weightedAStar");
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+	if (src == nullptr || dest == nullptr) {
+		return {{}, 0, -1};
+	}
+
+	int target = dest->getIndex();
+	SearchBuffers<LandmarkPotential> search(graph->getNumVertex(), {graph->getLandmarks(), target, factor});
+	search.start(src->getIndex());
+
+	// Settled vertices are not reopened: with a consistent bound the factor still holds
+	if (!searchKernel<DrivingWeight>(graph, search, AllEdges(), StopAtTarget{target})) {
+		return {{}, 0, ROUTE_TIMED_OUT};
+	}
+	if (!search.isSettled(target)) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<int> route;
+	for (Edge *cur = search.parent(target); cur != nullptr; cur = search.parent(cur->getOrig()->getIndex())) {
+		route.push_back(cur->getDest()->getId());
+	}
+	route.push_back(source);
+	std::reverse(route.begin(), route.end());
+	return {route, (int)route.size(), (int)search.dist(target), factor};
+}
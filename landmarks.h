@@ -0,0 +1,73 @@
+/**
+* @file landmarks.h
+ * @brief Landmark lower bounds on driving times (ALT), and the bounded-suboptimal driving search that uses them.
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+
+// Landmarks chosen by precomputeLandmarks() when no count is given
+const int DEFAULT_LANDMARKS = 16;
+
+/**
+ * @brief Driving times from a few landmarks to every vertex, which bound the time between any two vertices.
+ *
+ * By the triangle inequality, the time from v to t is at least |d(L, t) - d(L, v)| for every landmark L, since
+ * segments take the same time both ways. Closures only make times longer, so bounds computed on the open map stay
+ * valid under any closures. Landmarks are picked one at a time as the vertex farthest from those already picked,
+ * which spreads them over the edge of the map and covers every component.
+ */
+class LandmarkIndex {
+public:
+	/**
+	 * @brief Picks the landmarks and runs a driving search from each. O(K (V + E) log V).
+	 *
+	 * @param graph The graph, whose closures are taken into account.
+	 * @param count The number of landmarks K.
+	 */
+	LandmarkIndex(Graph *graph, int count);
+
+	/**
+	 * @brief Lower bound on the driving time between two vertices, by dense index. O(K).
+	 */
+	long lowerBound(int from, int to) const;
+
+	int getNumLandmarks() const;
+
+private:
+	int count = 0;
+
+	// dist[v * count + l] is the driving time from landmark l to vertex v, INT_MAX if unreachable
+	std::vector<int> dist;
+};
+
+/**
+ * @brief Picks landmarks for the graph and gives it their index.
+ *
+ * @param graph The graph.
+ * @param count The number of landmarks.
+ */
+void precomputeLandmarks(Graph *graph, int count = DEFAULT_LANDMARKS);
+
+/**
+ * @brief Computes a driving route at most a given factor longer than the best one, with weighted A*.
+ *
+ * Vertices are settled by g + factor * h, where g is the time from the source and h the landmark bound to the
+ * destination. The bound is consistent, so the route found is within the factor of the best, and a larger factor
+ * heads more greedily to the destination and settles fewer vertices. A factor of 1 gives the best route (A* with
+ * landmarks). Closed locations and segments are taken into account; without landmarks h is 0 and this is Dijkstra.
+ *
+ * @param graph The graph.
+ * @param source The ID of the source location.
+ * @param destination The ID of the destination location.
+ * @param factor The suboptimality factor, at least 1.
+ * @return The route, with time -1 if there is none (ROUTE_TIMED_OUT if the query deadline expired), and the
+ *         factor as its bound.
+ */
+Route boundedDrivingRoute(Graph *graph, int source, int destination, double factor);
+
+#endif //LANDMARKS_H
@@ -10,6 +10,8 @@
  * - Create driving only routes
  * - Create driving and walking routes
  * - Create routes with restrictions, like avoiding streets, locations, or including a specific location in your route
+ * - Find every location reachable within a time limit, by car or on foot (isochrones)
+ * - Run many route plans at once from a batch file
  *
  * @section usage Usage
  * The user should choose what input format it wants to use, either an input file or the terminal menu.
@@ -24,13 +26,16 @@
  * This program initializes the graph, handles user input, and invokes route planning
  * either from a file or from terminal input.
  */
-#include "Graph.h"
 #include "menu.h"
-#include "dataParser.h"
 #include "inputHandler.h"
-#include "algorithms.h"
+#include "routingCore.h"
+#include "batch.h"
+#include "trace.h"
+#include "queryLog.h"
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <string>
 
 /**
  * @brief Main function to execute the route planning program.
@@ -40,44 +45,126 @@
  * printed to the console.
  *
  * The input data is expected to be found inside the input_output directory, and it should be called input.txt.
- * The output.txt will contain the output, and it can e found in the same directory.
+ * The output.txt will contain the output, and it can e found in the same directory. In batch mode, the route plans are
+ * read from batch_input.txt (separated by blank lines) and the results written to batch_output.txt.
  *
  * The distances.csv and locations.csv should be inside smallSampleSize, and should have a valid representation of the
  * map that will be represented as graph.
  *
+ * Running the program as `main --all-pairs [file]` precomputes the driving and walking all-pairs matrices after loading
+ * the map, so route queries become table lookups. If a file is given, the matrices are loaded from it when it matches the
+ * map, and saved to it otherwise.
+ *
+ * The `--reorder` option renumbers the internal vertex indices so that neighbouring locations are close in memory.
+ * Location IDs and codes, and therefore the input and output formats, are unchanged.
+ *
+ * The `--parking-index radius` option precomputes, for every location, the parking locations within `radius` minutes
+ * of walking, so driving-walking queries with a maximum walking time up to the radius need no walking search.
+ *
+ * The `--turns file` option loads turn restrictions and turn penalties (see parseTurns) that driving routes obey.
+ *
+ * The `--overlay` option partitions the map into cells with precomputed overlays (see partitionOverlay.h), which
+ * answer the driving plans with avoided locations or segments.
+ *
+ * The `--trace file` option records a timeline of the run, from loading the map to writing the results, and saves
+ * it to the file as Chrome trace-event JSON (see trace.h) when the program ends.
+ *
+ * The `--query-log file` option records every route plan processed, with its time, to the file (see queryLog.h),
+ * for the replay tool to play back.
+ *
+ * The map is loaded and prepared by a RoutingEngine (see routingCore.h), in the same order whatever the order of the
+ * options; this program only reads the route plans and prints the results.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
  * @return int Exit status code.
  */
-int main() {
+int main(int argc, char *argv[]) {
 
-	Graph * graph = new Graph();
 	RoutePlan routePlan;
+	EngineOptions options;
+	std::string traceFile;
+	std::unique_ptr<QueryLog> queryLog;
+
+	// Tracing starts before the map is loaded, so the trace covers it
+	for (int arg = 1; arg + 1 < argc; arg++) {
+		if (std::string(argv[arg]) == "--trace") {
+			traceFile = argv[arg + 1];
+			startTracing();
+		}
+	}
+
+	for (int arg = 1; arg < argc; arg++) {
+		std::string option = argv[arg];
+
+		if (option == "--reorder") {
+			options.reorder = true;
+		}
+		else if (option == "--all-pairs") {
+			options.allPairs = true;
+			options.allPairsFile = arg + 1 < argc && argv[arg + 1][0] != '-' ? argv[++arg] : "";
+		}
+		else if (option == "--parking-index" && arg + 1 < argc) {
+			options.parkingRadius = std::stoi(argv[++arg]);
+		}
+		else if (option == "--tree-cache" && arg + 1 < argc) {
+			options.treeCacheMiB = std::stoul(argv[++arg]);
+		}
+		else if (option == "--turns" && arg + 1 < argc) {
+			options.turnsFile = argv[++arg];
+		}
+		else if (option == "--overlay") {
+			options.overlay = true;
+		}
+		else if (option == "--trace" && arg + 1 < argc) {
+			arg++;
+		}
+		else if (option == "--query-log" && arg + 1 < argc) {
+			queryLog.reset(new QueryLog(argv[++arg]));
+			setQueryLog(queryLog.get());
+		}
+	}
 
+	RoutingEngine * engine = new RoutingEngine("smallSampleSize/Locations.csv",
+											   "smallSampleSize/Distances.csv", options);
 
 	while (true) {
-		fileToGraph(graph, "smallSampleSize/Locations.csv",
-						"smallSampleSize/Distances.csv");
 		showMenu();
 		int choice = getMainMenuInput();
 
 		if (choice == 1) {
 			routePlan = fileRoutePlan();
 			std::ofstream outFile("input_output/output.txt");
-			resultMaker(graph, routePlan, outFile);
+			printPlanResult(routePlan, engine->plan(routePlan), outFile);
 			outFile.close();
 			break;
 		}
 
 		if (choice == 2) {
 			routePlan = showRoutePlanningMenu();
-			resultMaker(graph, routePlan, std::cout);
+			printPlanResult(routePlan, engine->plan(routePlan), std::cout);
 		}
 
 		if (choice == 3) {
+			std::vector<RoutePlan> routePlans = fileRoutePlans("input_output/batch_input.txt");
+			std::ofstream outFile("input_output/batch_output.txt");
+			runBatch(engine->getGraph(), routePlans, outFile);
+			outFile.close();
+			break;
+		}
+
+		if (choice == 4) {
 			break;
 		}
 	}
 
-	delete graph;
+	delete engine;
+	setQueryLog(nullptr);
+
+	if (!traceFile.empty()) {
+		stopTracing();
+		saveTrace(traceFile);
+	}
 
 	return 0;
 }
@@ -5,7 +5,8 @@ void showMenu() {
 	std::cout << "\nRoute Planning Analysis Tool\n";
 	std::cout << "1. Route Planning with input file\n";
 	std::cout << "2. Route Planning from terminal menu\n";
-	std::cout << "3. Exit\n";
+	std::cout << "3. Batch Route Planning with batch input file\n";
+	std::cout << "4. Exit\n";
 	std::cout << "Enter choice: ";
 }
 
@@ -9,8 +9,8 @@
 /**
  * @brief Displays the main menu of the route planning tool.
  *
- * The menu gives the user options for route planning with a file or from the terminal,
- * as well as an option to exit the program.
+ * The menu gives the user options for route planning with a file, from the terminal or with
+ * a batch file holding many route plans, as well as an option to exit the program.
  */
 void showMenu();
 
@@ -0,0 +1,115 @@
+#include "parkingIndex.h"
+#include "searchKernel.h"
+#include <algorithm>
+
+namespace {
+
+struct Walk {
+	int v;
+	int time;
+	int previous;
+};
+
+// Records the settled vertices with their walking time and the vertex they are reached from
+
+struct WalkRecorder {
+	std::vector<Walk> &out;
+
+	void settled(int v, long dist, const Edge *parent) {
+		out.push_back({v, (int)dist, parent == nullptr ? -1 : parent->getOrig()->getIndex()});
+	}
+};
+
+// The search buffers belong to a worker; only the touched entries are reset between searches
+
+void boundedWalk(const Graph *graph, int parking, int radius, SearchBuffers<> &search, std::vector<Walk> &out) {
+	search.start(parking);
+	searchKernel<WalkingWeight>(graph, search, WithinBound{radius}, Exhaustive(), WalkRecorder{out});
+}
+
+}
+
+ParkingIndex::ParkingIndex(const Graph *graph, int radius, WorkerPool &pool) : graph(graph), radius(radius) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int n = vertices.size();
+
+	std::vector<int> parkings;
+	for (auto v : vertices) {
+		if (v->getParking() && !v->isClosed()) {
+			parkings.push_back(v->getIndex());
+		}
+	}
+	numParking = parkings.size();
+
+	std::vector<std::vector<Walk>> walks(parkings.size());
+	std::vector<SearchBuffers<>> searches(pool.size(), SearchBuffers<>(n));
+
+	pool.run(parkings.size(), [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t i = begin; i < end; i++) {
+			boundedWalk(graph, parkings[i], radius, searches[worker], walks[i]);
+		}
+	}, 1);
+
+	// Parking locations are visited in index order, so every inverted list ends up sorted by parking location
+	lists.resize(n);
+	for (size_t i = 0; i < parkings.size(); i++) {
+		for (auto &walk : walks[i]) {
+			lists[walk.v].push_back({parkings[i], walk.time, walk.previous});
+		}
+		std::vector<Walk>().swap(walks[i]);
+	}
+}
+
+int ParkingIndex::getRadius() const {
+	return radius;
+}
+
+int ParkingIndex::getNumParking() const {
+	return numParking;
+}
+
+size_t ParkingIndex::getNumEntries() const {
+	size_t entries = 0;
+	for (auto &list : lists) {
+		entries += list.size();
+	}
+	return entries;
+}
+
+const std::vector<ParkingIndex::Entry> &ParkingIndex::walksTo(int v) const {
+	return lists[v];
+}
+
+const ParkingIndex::Entry *ParkingIndex::find(int parking, int v) const {
+	auto it = std::lower_bound(lists[v].begin(), lists[v].end(), parking, [](const Entry &entry, int value) {
+		return entry.parking < value;
+	});
+	return it != lists[v].end() && it->parking == parking ? &*it : nullptr;
+}
+
+Route ParkingIndex::walkingRoute(int parking, int v) const {
+	const Entry *entry = find(parking, v);
+	if (entry == nullptr) {
+		return {{}, 0, -1};
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	Route route = {{}, 0, entry->time};
+
+	// Every location on the walk is within the radius too, so its entry for this parking location exists
+	for (int cur = v; cur != -1; cur = find(parking, cur)->previous) {
+		route.r.push_back(vertices[cur]->getId());
+	}
+	std::reverse(route.r.begin(), route.r.end());
+	route.length = route.r.size();
+	return route;
+}
+
+bool precomputeParkingIndex(Graph *graph, int radius) {
+	if (graph->hasClosures()) {
+		return false;
+	}
+
+	graph->setParkingIndex(new ParkingIndex(graph, radius));
+	return true;
+}
@@ -0,0 +1,84 @@
+/**
+* @file parkingIndex.h
+ * @brief Precomputed walking distances from every parking location to the locations around it.
+ */
+
+#ifndef PARKINGINDEX_H
+#define PARKINGINDEX_H
+
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+#include "workerPool.h"
+
+/**
+ * @brief For each location, the parking locations within a walking radius and the walking time from each.
+ *
+ * A walking search bounded by the radius is run from every parking location, and its results are stored as
+ * inverted lists: the list of a location holds one entry per parking location that reaches it, sorted by the
+ * index of the parking location. Each entry keeps the previous location of the walk, so a walking route is
+ * read back from the lists without any search. Entries only exist for walks of at most the radius.
+ */
+class ParkingIndex {
+public:
+	/**
+	 * @brief Entry of an inverted list: a parking location (dense index), the walking time from it, and the
+	 * location (dense index) before this one on the walk, or -1 at the parking location itself.
+	 */
+	struct Entry {
+		int parking;
+		int time;
+		int previous;
+	};
+
+	/**
+	 * @brief Builds the index for the open locations and segments of a graph.
+	 *
+	 * The searches are run in parallel. The time complexity is O(P (R + E_R) log R), where P is the number of
+	 * parking locations and R the number of locations within the radius of one.
+	 *
+	 * @param graph The graph.
+	 * @param radius The maximum walking time stored.
+	 * @param pool The threads used to run the searches.
+	 */
+	ParkingIndex(const Graph *graph, int radius, WorkerPool &pool = WorkerPool::shared());
+
+	int getRadius() const;
+	int getNumParking() const;
+	size_t getNumEntries() const;
+
+	/**
+	 * @brief Parking locations within the radius of a location, sorted by their dense index.
+	 *
+	 * @param v The dense index of the location.
+	 */
+	const std::vector<Entry> &walksTo(int v) const;
+
+	/**
+	 * @brief Walking route from a parking location to a location within its radius.
+	 *
+	 * @param parking The dense index of the parking location.
+	 * @param v The dense index of the location.
+	 * @return The route, from the parking location to v, with time -1 if v is not within the radius.
+	 */
+	Route walkingRoute(int parking, int v) const;
+
+private:
+	const Entry *find(int parking, int v) const;
+
+	const Graph *graph;
+	int radius;
+	int numParking = 0;
+	std::vector<std::vector<Entry>> lists;
+};
+
+/**
+ * @brief Builds the parking index and stores it in the graph, where driving-walking queries will use it.
+ *
+ * @param graph The graph.
+ * @param radius The maximum walking time stored; queries with a larger maximum walking time do not use the index.
+ * @return False if the graph has pending closures, in which case nothing is computed.
+ */
+bool precomputeParkingIndex(Graph *graph, int radius);
+
+#endif //PARKINGINDEX_H
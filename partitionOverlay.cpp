@@ -0,0 +1,453 @@
+#include "partitionOverlay.h"
+#include "deadline.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+namespace {
+
+const long INF = LONG_MAX / 4;
+
+// Node of the bisection tree: the vertices order[begin, end) and the two halves they were split in
+
+struct BisectionNode {
+	int begin;
+	int end;
+	int left;
+	int right;
+};
+
+// Undirected adjacency, used for the partition only (it does not depend on the weights)
+
+struct Neighbours {
+	std::vector<int> offsets;
+	std::vector<int> nodes;
+
+	const int *begin(int v) const { return nodes.data() + offsets[v]; }
+	const int *end(int v) const { return nodes.data() + offsets[v + 1]; }
+};
+
+// Breadth-first order of the vertices with mark == stamp, starting at root and then at each unreached one
+
+void bfsOrder(const Neighbours &neighbours, const std::vector<int> &candidates, int root, std::vector<int> &mark,
+			  int stamp, std::vector<int> &out) {
+	out.clear();
+	for (size_t i = 0; i <= candidates.size(); i++) {
+		int start = i == 0 ? root : candidates[i - 1];
+		if (mark[start] != stamp) {
+			continue;
+		}
+		mark[start] = -stamp;
+		out.push_back(start);
+
+		for (size_t head = out.size() - 1; head < out.size(); head++) {
+			for (const int *u = neighbours.begin(out[head]); u != neighbours.end(out[head]); u++) {
+				if (mark[*u] == stamp) {
+					mark[*u] = -stamp;
+					out.push_back(*u);
+				}
+			}
+		}
+	}
+	for (int v : out) {
+		mark[v] = stamp;
+	}
+}
+
+}
+
+// Dijkstra buffers; only the touched entries are reset between searches
+
+struct OverlayGraph::Search {
+	std::vector<long> dist;
+	std::vector<int> parent;
+	// 0 if the vertex was reached by an original arc, l if by an overlay arc of level l
+	std::vector<int> parentLevel;
+	std::vector<int> touched;
+	std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>,
+		std::greater<std::pair<long, int>>> queue;
+
+	explicit Search(int n = 0) : dist(n, INF), parent(n, -1), parentLevel(n, 0) {}
+
+	void update(int v, long d, int from, int level) {
+		if (d >= dist[v]) {
+			return;
+		}
+		if (dist[v] == INF) {
+			touched.push_back(v);
+		}
+		dist[v] = d;
+		parent[v] = from;
+		parentLevel[v] = level;
+		queue.emplace(d, v);
+	}
+
+	void reset() {
+		for (int v : touched) {
+			dist[v] = INF;
+			parent[v] = -1;
+			parentLevel[v] = 0;
+		}
+		touched.clear();
+		queue = {};
+	}
+};
+
+OverlayGraph::OverlayGraph(const Graph *graph, int cellSize) : graph(graph) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int n = vertices.size();
+
+	offsets.assign(n + 1, 0);
+	for (int v = 0; v < n; v++) {
+		offsets[v + 1] = offsets[v] + vertices[v]->getAdj().size();
+		for (auto e : vertices[v]->getAdj()) {
+			heads.push_back(e->getDest()->getIndex());
+			edges.push_back(e);
+		}
+	}
+	weights.assign(heads.size(), INF);
+
+	Neighbours neighbours;
+	neighbours.offsets.assign(n + 1, 0);
+	for (int v = 0; v < n; v++) {
+		neighbours.offsets[v + 1] = neighbours.offsets[v] + vertices[v]->getAdj().size()
+			+ vertices[v]->getIncoming().size();
+		for (auto e : vertices[v]->getAdj()) {
+			neighbours.nodes.push_back(e->getDest()->getIndex());
+		}
+		for (auto e : vertices[v]->getIncoming()) {
+			neighbours.nodes.push_back(e->getOrig()->getIndex());
+		}
+	}
+
+	// Recursive bisection: each range of `order` is split in half along a BFS order that starts at a
+	// pseudo-peripheral vertex, so both halves tend to be compact and the cut between them small
+	std::vector<int> order(n);
+	for (int v = 0; v < n; v++) {
+		order[v] = v;
+	}
+	std::vector<BisectionNode> tree;
+	std::vector<int> mark(n, 0), bfs, range;
+
+	std::function<int(int, int)> bisect = [&](int begin, int end) {
+		int node = tree.size();
+		tree.push_back({begin, end, -1, -1});
+		if (end - begin <= cellSize) {
+			return node;
+		}
+
+		int stamp = node + 1;
+		range.assign(order.begin() + begin, order.begin() + end);
+		for (int v : range) {
+			mark[v] = stamp;
+		}
+		bfsOrder(neighbours, {}, range[0], mark, stamp, bfs);
+		bfsOrder(neighbours, range, bfs.back(), mark, stamp, bfs);
+		std::copy(bfs.begin(), bfs.end(), order.begin() + begin);
+
+		int middle = begin + (end - begin) / 2;
+		int left = bisect(begin, middle);
+		int right = bisect(middle, end);
+		tree[node].left = left;
+		tree[node].right = right;
+		return node;
+	};
+	if (n > 0) {
+		bisect(0, n);
+	}
+
+	// The cells of a level are the largest nodes of the tree that fit its size, so they nest across levels
+	for (long size = cellSize; size < n; size *= 8) {
+		std::vector<int> cell(n);
+		int numCells = 0;
+
+		std::function<void(int)> assign = [&](int node) {
+			if (tree[node].end - tree[node].begin <= size) {
+				for (int i = tree[node].begin; i < tree[node].end; i++) {
+					cell[order[i]] = numCells;
+				}
+				numCells++;
+				return;
+			}
+			assign(tree[node].left);
+			assign(tree[node].right);
+		};
+		assign(0);
+
+		std::vector<std::vector<int>> cellBoundary(numCells);
+		std::vector<int> index(n, -1);
+		for (int v = 0; v < n; v++) {
+			bool cut = std::any_of(neighbours.begin(v), neighbours.end(v), [&](int u) { return cell[u] != cell[v]; });
+			if (cut) {
+				index[v] = cellBoundary[cell[v]].size();
+				cellBoundary[cell[v]].push_back(v);
+			}
+		}
+
+		cells.push_back(std::move(cell));
+		boundary.push_back(std::move(cellBoundary));
+		boundaryIndex.push_back(std::move(index));
+	}
+	clique.resize(cells.size());
+}
+
+int OverlayGraph::getNumLevels() const {
+	return cells.size();
+}
+
+int OverlayGraph::getNumCells(int level) const {
+	return boundary[level - 1].size();
+}
+
+int OverlayGraph::cellOf(int level, int v) const {
+	return cells[level - 1][v];
+}
+
+void OverlayGraph::customize(Metric metric, WorkerPool &pool) {
+	this->metric = metric;
+
+	for (size_t i = 0; i < edges.size(); i++) {
+		Edge *e = edges[i];
+		int w = e->getWeight(metric);
+		bool open = !e->isClosed() && !e->getOrig()->isClosed() && !e->getDest()->isClosed();
+		weights[i] = open && w != INT_MAX ? w : INF;
+	}
+
+	int n = graph->getNumVertex();
+	std::vector<Search> searches(pool.size(), Search(n));
+
+	for (int level = 1; level <= getNumLevels(); level++) {
+		std::vector<std::vector<long>> &levelClique = clique[level - 1];
+		levelClique.assign(getNumCells(level), {});
+
+		pool.run(getNumCells(level), [&](size_t begin, size_t end, unsigned worker) {
+			Search &search = searches[worker];
+
+			for (size_t cell = begin; cell < end; cell++) {
+				const std::vector<int> &points = boundary[level - 1][cell];
+				size_t k = points.size();
+				levelClique[cell].assign(k * k, INF);
+
+				for (size_t i = 0; i < k; i++) {
+					cellSearch(level, cell, level - 1, points[i], search);
+					for (size_t j = 0; j < k; j++) {
+						levelClique[cell][i * k + j] = search.dist[points[j]];
+					}
+					search.reset();
+				}
+			}
+		}, 1);
+	}
+
+	customized = true;
+}
+
+void OverlayGraph::invalidate() {
+	customized = false;
+}
+
+bool OverlayGraph::isCustomized() const {
+	return customized;
+}
+
+Metric OverlayGraph::getMetric() const {
+	return metric;
+}
+
+/*
+ * Relaxes the arcs leaving v in the overlay of the given level: the clique of its cell and the original arcs
+ * leaving that cell, or every original arc at level 0. Only vertices inside the restriction cell are reached
+ * (no restriction if restrictLevel is 0), and excluded arcs and vertices are skipped.
+ */
+
+void OverlayGraph::relax(int v, int level, int restrictLevel, int restrictCell,
+						 const std::vector<bool> *excludedArcs, const std::vector<bool> *excludedVertices,
+						 Search &search) const {
+	long d = search.dist[v];
+
+	if (level > 0) {
+		int cell = cellOf(level, v);
+		const std::vector<int> &points = boundary[level - 1][cell];
+		const long *row = clique[level - 1][cell].data() + boundaryIndex[level - 1][v] * points.size();
+
+		for (size_t j = 0; j < points.size(); j++) {
+			if (row[j] != INF && points[j] != v) {
+				search.update(points[j], d + row[j], v, level);
+			}
+		}
+	}
+
+	for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+		int u = heads[i];
+		if (weights[i] == INF || (level > 0 && cellOf(level, u) == cellOf(level, v))) {
+			continue;
+		}
+		if (restrictLevel > 0 && cellOf(restrictLevel, u) != restrictCell) {
+			continue;
+		}
+		if ((excludedArcs && (*excludedArcs)[i]) || (excludedVertices && (*excludedVertices)[u])) {
+			continue;
+		}
+		search.update(u, d + weights[i], v, 0);
+	}
+}
+
+/*
+ * Dijkstra from a boundary vertex that stays inside a cell of the given level, using the overlays of useLevel
+ * (the sub-cells) or the original arcs if useLevel is 0.
+ */
+
+void OverlayGraph::cellSearch(int level, int cell, int useLevel, int source, Search &search) const {
+	search.update(source, 0, -1, 0);
+
+	while (!search.queue.empty()) {
+		auto [d, v] = search.queue.top();
+		search.queue.pop();
+		if (d != search.dist[v]) {
+			continue;
+		}
+		relax(v, useLevel, level, cell, nullptr, nullptr, search);
+	}
+}
+
+/*
+ * Appends to out the vertices after `from` on the shortest path to `to` inside their cell of the given level,
+ * expanding the overlay arcs of lower levels recursively.
+ */
+
+void OverlayGraph::unpack(int from, int to, int level, std::vector<int> &out, Search &search) const {
+	cellSearch(level, cellOf(level, from), level - 1, from, search);
+
+	std::vector<std::pair<int, int>> steps;
+	for (int v = to; v != from; v = search.parent[v]) {
+		steps.emplace_back(v, search.parentLevel[v]);
+	}
+	std::reverse(steps.begin(), steps.end());
+	search.reset();
+
+	int prev = from;
+	for (auto [v, stepLevel] : steps) {
+		if (stepLevel > 0) {
+			unpack(prev, v, stepLevel, out, search);
+		}
+		else {
+			out.push_back(v);
+		}
+		prev = v;
+	}
+}
+
+Route OverlayGraph::route(int source, int destination, const std::vector<int> &avoidNodes,
+						  const std::vector<std::pair<int, int>> &avoidSegments) const {
+	TraceSpan span("overlaySearch");
+	Vertex *src = graph->findVertexById(source);
+	Vertex *dest = graph->findVertexById(destination);
+	if (!customized || !src || !dest) {
+		return {{}, 0, -1};
+	}
+
+	int n = graph->getNumVertex();
+	int s = src->getIndex(), t = dest->getIndex();
+
+	// Cells holding an excluded vertex or arc cannot use their overlay for this query
+	std::vector<bool> excludedVertices(n, false), excludedArcs(heads.size(), false);
+	std::vector<std::vector<bool>> dirty(getNumLevels());
+	for (int level = 1; level <= getNumLevels(); level++) {
+		dirty[level - 1].assign(getNumCells(level), false);
+	}
+	auto markDirty = [&](int v) {
+		for (int level = 1; level <= getNumLevels(); level++) {
+			dirty[level - 1][cellOf(level, v)] = true;
+		}
+	};
+
+	for (int id : avoidNodes) {
+		if (Vertex *v = graph->findVertexById(id)) {
+			excludedVertices[v->getIndex()] = true;
+			markDirty(v->getIndex());
+		}
+	}
+	for (auto &[id1, id2] : avoidSegments) {
+		Vertex *v1 = graph->findVertexById(id1), *v2 = graph->findVertexById(id2);
+		if (!v1 || !v2) {
+			continue;
+		}
+		for (auto [a, b] : {std::make_pair(v1->getIndex(), v2->getIndex()),
+							std::make_pair(v2->getIndex(), v1->getIndex())}) {
+			for (int i = offsets[a]; i < offsets[a + 1]; i++) {
+				if (heads[i] == b) {
+					excludedArcs[i] = true;
+					markDirty(a);
+					markDirty(b);
+				}
+			}
+		}
+	}
+
+	// A vertex is searched at the highest level where its cell holds neither endpoint and is not dirty
+	auto queryLevel = [&](int v) {
+		for (int level = getNumLevels(); level > 0; level--) {
+			int cell = cellOf(level, v);
+			if (cell != cellOf(level, s) && cell != cellOf(level, t) && !dirty[level - 1][cell]) {
+				return level;
+			}
+		}
+		return 0;
+	};
+
+	Search search(n);
+	search.update(s, 0, -1, 0);
+	DeadlinePoll interrupted;
+
+	while (!search.queue.empty()) {
+		auto [d, v] = search.queue.top();
+		search.queue.pop();
+		if (d != search.dist[v]) {
+			continue;
+		}
+		if (v == t) {
+			break;
+		}
+		if (interrupted()) {
+			return {{}, 0, ROUTE_TIMED_OUT};
+		}
+		relax(v, queryLevel(v), 0, -1, &excludedArcs, &excludedVertices, search);
+	}
+
+	if (search.dist[t] == INF) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<std::pair<int, int>> steps;
+	for (int v = t; v != s; v = search.parent[v]) {
+		steps.emplace_back(v, search.parentLevel[v]);
+	}
+	std::reverse(steps.begin(), steps.end());
+	int time = search.dist[t];
+	search.reset();
+
+	std::vector<int> path = {s};
+	for (auto [v, level] : steps) {
+		if (level > 0) {
+			unpack(path.back(), v, level, path, search);
+		}
+		else {
+			path.push_back(v);
+		}
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	std::vector<int> route;
+	for (int v : path) {
+		route.push_back(vertices[v]->getId());
+	}
+	return {route, (int)route.size(), time};
+}
+
+void precomputeOverlay(Graph *graph, int cellSize) {
+	OverlayGraph *overlay = new OverlayGraph(graph, cellSize);
+	overlay->customize(Metric::Driving);
+	graph->setOverlay(overlay);
+}
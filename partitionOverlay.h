@@ -0,0 +1,118 @@
+/**
+* @file partitionOverlay.h
+ * @brief Customizable route planning: a multi-level partition of the graph with overlay cliques.
+ *
+ * The preprocessing is split in two. The partition only depends on the road topology and is computed once.
+ * The customization computes, for every cell, the shortest distances between its boundary vertices, and is
+ * redone in well under a second whenever the weights change (for example, from a traffic feed). Queries then
+ * skip over every cell that contains neither endpoint using its overlay clique, and fall back to finer cells,
+ * down to the original edges, only where an avoided location or segment makes the overlay invalid.
+ */
+
+#ifndef PARTITIONOVERLAY_H
+#define PARTITIONOVERLAY_H
+
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+#include "workerPool.h"
+
+/**
+ * @brief Multi-level partition of a graph with one overlay clique per cell.
+ *
+ * Level 0 is the original graph. A cell of level l is a union of cells of level l - 1. A vertex is a boundary
+ * vertex of a level when it has an edge to a vertex of another cell of that level; the overlay of a cell holds
+ * the shortest distance, inside the cell, from each of its boundary vertices to each other.
+ */
+class OverlayGraph {
+public:
+	/**
+	 * @brief Partitions the graph by recursive bisection along BFS orders.
+	 *
+	 * The level 1 cells have at most `cellSize` vertices and each level above allows 8 times more, until a
+	 * single cell would hold the whole graph. The overlays are not usable until customize() is called.
+	 * Only the topology is used, so the partition stays valid when the weights change.
+	 *
+	 * @param graph The graph; its open edges at this point define the topology.
+	 * @param cellSize The maximum number of vertices of a level 1 cell.
+	 */
+	explicit OverlayGraph(const Graph *graph, int cellSize = 64);
+
+	int getNumLevels() const;
+	int getNumCells(int level) const;
+
+	/**
+	 * @brief Computes the overlay cliques for the current weights of the graph.
+	 *
+	 * Cells are customized level by level, in parallel; a cell of level l only searches the overlays of its
+	 * sub-cells. Segments that are closed at this point are treated as missing.
+	 *
+	 * @param metric The weight to use.
+	 * @param pool The threads used to customize the cells.
+	 */
+	void customize(Metric metric, WorkerPool &pool = WorkerPool::shared());
+
+	/**
+	 * @brief Marks the overlays as outdated, after the weights of the graph changed. The partition is kept, and
+	 * route() finds no route until customize() is called again.
+	 */
+	void invalidate();
+
+	bool isCustomized() const;
+	Metric getMetric() const;
+
+	/**
+	 * @brief Computes the best route between two locations using the overlays.
+	 *
+	 * Avoided locations and segments are excluded for this query only: the cells containing them are
+	 * searched with their sub-cells (down to the original edges) instead of their own overlay.
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @param avoidNodes The IDs of locations to avoid.
+	 * @param avoidSegments The segments to avoid, as pairs of location IDs (both directions are avoided).
+	 * @return The route, with time -1 if there is none (or the overlays are not customized), or ROUTE_TIMED_OUT if
+	 * the query deadline passed.
+	 */
+	Route route(int source, int destination, const std::vector<int> &avoidNodes = {},
+				const std::vector<std::pair<int, int>> &avoidSegments = {}) const;
+
+private:
+	struct Search;
+
+	int cellOf(int level, int v) const;
+	void cellSearch(int level, int cell, int useLevel, int source, Search &search) const;
+	void relax(int v, int level, int restrictLevel, int restrictCell, const std::vector<bool> *excludedArcs,
+			   const std::vector<bool> *excludedVertices, Search &search) const;
+	void unpack(int from, int to, int level, std::vector<int> &out, Search &search) const;
+
+	const Graph *graph;
+	Metric metric = Metric::Driving;
+	bool customized = false;
+
+	// Original arcs, in compressed sparse row form, with the edge each one comes from
+	std::vector<int> offsets;
+	std::vector<int> heads;
+	std::vector<Edge *> edges;
+	std::vector<long> weights;
+
+	// cells[l - 1][v] is the cell of v at level l
+	std::vector<std::vector<int>> cells;
+	// boundary[l - 1][c] lists the boundary vertices of cell c of level l, and boundaryIndex their position there
+	std::vector<std::vector<std::vector<int>>> boundary;
+	std::vector<std::vector<int>> boundaryIndex;
+	// clique[l - 1][c] is the row-major distance matrix between the boundary vertices of the cell
+	std::vector<std::vector<std::vector<long>>> clique;
+};
+
+/**
+ * @brief Partitions the graph and customizes the overlays for driving, so that driving plans with avoided
+ * locations or segments are answered by OverlayGraph::route(). The graph owns the result (see Graph::getOverlay()).
+ *
+ * @param graph The graph.
+ * @param cellSize The maximum number of vertices of a level 1 cell.
+ */
+void precomputeOverlay(Graph *graph, int cellSize = 64);
+
+#endif //PARTITIONOVERLAY_H
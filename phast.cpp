@@ -0,0 +1,133 @@
+#include "phast.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+namespace {
+
+// Distance of the vertices not reached yet; small enough that adding an arc weight cannot overflow
+const int32_t UNREACHED = INT_MAX / 2;
+
+#if defined(__GNUC__)
+
+// Four lanes per 128-bit vector, the width every x86-64 (SSE2) and ARM64 (NEON) processor has
+typedef int32_t LaneQuad __attribute__((vector_size(4 * sizeof(int32_t))));
+
+struct LaneVector {
+	LaneQuad quad[PHAST_LANES / 4];
+
+	int32_t get(int i) const { return quad[i / 4][i % 4]; }
+	void set(int i, int32_t value) { quad[i / 4][i % 4] = value; }
+};
+
+inline void relaxLanes(LaneVector &current, const LaneVector &tail, int32_t weight) {
+	for (int q = 0; q < PHAST_LANES / 4; q++) {
+		LaneQuad candidate = tail.quad[q] + weight;
+		LaneQuad shorter = candidate < current.quad[q];
+		current.quad[q] = (candidate & shorter) | (current.quad[q] & ~shorter);
+	}
+}
+
+#else
+
+struct LaneVector {
+	int32_t lane[PHAST_LANES];
+
+	int32_t get(int i) const { return lane[i]; }
+	void set(int i, int32_t value) { lane[i] = value; }
+};
+
+inline void relaxLanes(LaneVector &current, const LaneVector &tail, int32_t weight) {
+	for (int i = 0; i < PHAST_LANES; i++) {
+		if (tail.lane[i] + weight < current.lane[i]) {
+			current.lane[i] = tail.lane[i] + weight;
+		}
+	}
+}
+
+#endif
+
+}
+
+// One entry per sweep position, the lane i holding the distance from the source i
+struct PhastEngine::Lanes {
+	std::vector<LaneVector> dist;
+};
+
+PhastEngine::PhastEngine(const Graph *graph, Metric metric) : graph(graph), hierarchy(graph, metric) {
+	int n = hierarchy.size();
+	const std::vector<int> &order = hierarchy.getOrder();
+
+	vertexAt.assign(order.rbegin(), order.rend());
+	position.resize(n);
+	for (int p = 0; p < n; p++) {
+		position[vertexAt[p]] = p;
+	}
+
+	downOffsets.push_back(0);
+	for (int p = 0; p < n; p++) {
+		int v = vertexAt[p];
+		for (int arc = hierarchy.downBegin(v); arc < hierarchy.downEnd(v); arc++) {
+			downTails.push_back(position[hierarchy.getDownTail(arc)]);
+			downWeights.push_back(hierarchy.getDownWeight(arc));
+		}
+		downOffsets.push_back(downTails.size());
+	}
+}
+
+void PhastEngine::sweep(const int *sources, int count, std::vector<int> *out, Lanes &lanes,
+						UpwardSearch &search) const {
+	TraceSpan span("phastSweep");
+	int n = vertexAt.size();
+	LaneVector unreached;
+	for (int i = 0; i < PHAST_LANES; i++) {
+		unreached.set(i, UNREACHED);
+	}
+	lanes.dist.assign(n, unreached);
+
+	for (int i = 0; i < count; i++) {
+		Vertex *src = graph->findVertexById(sources[i]);
+		if (src == nullptr) {
+			continue;
+		}
+		hierarchy.upwardSearch(src->getIndex(), false, search);
+		for (int v : search.settled) {
+			lanes.dist[position[v]].set(i, search.dist[v]);
+		}
+	}
+
+	// Every tail ranks higher than its head, so it comes earlier in the sweep and is already final
+	for (int p = 0; p < n; p++) {
+		LaneVector dist = lanes.dist[p];
+		for (int arc = downOffsets[p]; arc < downOffsets[p + 1]; arc++) {
+			relaxLanes(dist, lanes.dist[downTails[arc]], downWeights[arc]);
+		}
+		lanes.dist[p] = dist;
+	}
+
+	for (int i = 0; i < count; i++) {
+		out[i].resize(n);
+		for (int p = 0; p < n; p++) {
+			int32_t dist = lanes.dist[p].get(i);
+			out[i][vertexAt[p]] = dist >= UNREACHED ? INT_MAX : dist;
+		}
+	}
+}
+
+std::vector<std::vector<int>> PhastEngine::distances(const std::vector<int> &sources, WorkerPool &pool) const {
+	std::vector<std::vector<int>> result(sources.size());
+	size_t sweeps = (sources.size() + PHAST_LANES - 1) / PHAST_LANES;
+	std::vector<Lanes> lanes(pool.size());
+	std::vector<UpwardSearch> searches(pool.size(), UpwardSearch(hierarchy.size()));
+
+	pool.run(sweeps, [&](size_t begin, size_t end, unsigned worker) {
+		for (size_t s = begin; s < end; s++) {
+			size_t first = s * PHAST_LANES;
+			int count = std::min<size_t>(PHAST_LANES, sources.size() - first);
+			sweep(sources.data() + first, count, result.data() + first, lanes[worker], searches[worker]);
+		}
+	}, 1);
+
+	return result;
+}
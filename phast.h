@@ -0,0 +1,68 @@
+/**
+* @file phast.h
+ * @brief One-to-all distances from many sources at once, by linear sweeps over a contraction hierarchy (PHAST).
+ */
+
+#ifndef PHAST_H
+#define PHAST_H
+
+#include <vector>
+#include "Graph.h"
+#include "contractionHierarchy.h"
+#include "workerPool.h"
+
+// Sources handled by one sweep, one per SIMD lane of 32-bit distances; a multiple of 4 (lanes per 128-bit vector)
+const int PHAST_LANES = 8;
+
+/**
+ * @brief PHAST engine: an upward search from each source, then one sweep over the vertices from the highest rank
+ * down.
+ *
+ * After the upward searches, relaxing the downward arcs of every vertex in decreasing rank order leaves the exact
+ * distances from the sources, with no priority queue. The vertices are stored in sweep order, so the sweep reads
+ * the arrays front to back, and each entry holds the distances of PHAST_LANES sources side by side, relaxed
+ * together with vector instructions.
+ */
+class PhastEngine {
+public:
+	/**
+	 * @brief Builds the hierarchy of a graph for one metric and lays it out in sweep order.
+	 *
+	 * @param graph The graph, whose closures are taken into account. Later changes are not seen.
+	 * @param metric The weight to use.
+	 */
+	PhastEngine(const Graph *graph, Metric metric);
+
+	/**
+	 * @brief Computes the distances from every source to every location.
+	 *
+	 * Sources are swept PHAST_LANES at a time, sweeps run in parallel. Each sweep costs O(V + E') for E' edges in the
+	 * hierarchy, whatever the number of sources in it.
+	 *
+	 * @param sources The IDs of the sources.
+	 * @param pool The threads used to run the sweeps.
+	 * @return For each source, the distance to each location by dense index (INT_MAX if unreachable; all INT_MAX if
+	 *         the source does not exist).
+	 */
+	std::vector<std::vector<int>> distances(const std::vector<int> &sources,
+											WorkerPool &pool = WorkerPool::shared()) const;
+
+private:
+	struct Lanes;
+
+	void sweep(const int *sources, int count, std::vector<int> *out, Lanes &lanes, UpwardSearch &search) const;
+
+	const Graph *graph;
+	ContractionHierarchy hierarchy;
+
+	// vertexAt[p] is the vertex (dense index) at sweep position p, position[v] the reverse
+	std::vector<int> vertexAt;
+	std::vector<int> position;
+
+	// Arcs from higher ranked vertices into the vertex at each position, with the tail's position
+	std::vector<int> downOffsets;
+	std::vector<int> downTails;
+	std::vector<int> downWeights;
+};
+
+#endif //PHAST_H
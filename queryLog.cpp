@@ -0,0 +1,72 @@
+#include "queryLog.h"
+#include <atomic>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::atomic<QueryLog *> currentLog{nullptr};
+
+}
+
+QueryLog::QueryLog(const std::string &filename) : file(filename), origin(std::chrono::steady_clock::now()) {}
+
+bool QueryLog::isOpen() const {
+	return file.is_open();
+}
+
+void QueryLog::record(const RoutePlan &routePlan) {
+	long offset = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+
+	// The line is built outside the lock, so concurrent callers only wait for the write
+	std::ostringstream line;
+	line << offset << ';';
+	writeRoutePlan(routePlan, line, ';');
+	line << '\n';
+
+	std::lock_guard<std::mutex> lock(mutex);
+	file << line.str();
+}
+
+void setQueryLog(QueryLog *log) {
+	currentLog.store(log);
+}
+
+void logQuery(const RoutePlan &routePlan) {
+	QueryLog *log = currentLog.load();
+	if (log != nullptr) {
+		log->record(routePlan);
+	}
+}
+
+std::vector<LoggedQuery> readQueryLog(const std::string &filename) {
+	std::vector<LoggedQuery> queries;
+	std::ifstream file(filename);
+
+	if (!file.is_open()) {
+		std::cerr << "Error: Could not open file: " << filename << std::endl;
+		return queries;
+	}
+
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		std::stringstream ss(line);
+		std::string field;
+		std::getline(ss, field, ';');
+
+		LoggedQuery query = {std::stol(field), {"", -1, -1, -1, {}, {}, {}}};
+		while (std::getline(ss, field, ';')) {
+			size_t colon = field.find(':');
+			if (colon != std::string::npos) {
+				parseRoutePlanField(query.routePlan, field.substr(0, colon), field.substr(colon + 1));
+			}
+		}
+		queries.push_back(query);
+	}
+
+	return queries;
+}
@@ -0,0 +1,68 @@
+/**
+* @file queryLog.h
+ * @brief Capture of the route plans processed, with their timestamps, for replaying real traffic later.
+ */
+
+#ifndef QUERYLOG_H
+#define QUERYLOG_H
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "inputHandler.h"
+
+/**
+ * @brief Log of route plans, one line each: the time since the log was opened, in microseconds, then the plan's
+ * fields separated by ';' (see writeRoutePlan()).
+ *
+ * Recording is thread-safe. Lines are buffered, and the file is complete once the log is destroyed.
+ */
+class QueryLog {
+public:
+	/**
+	 * @brief Opens a log file for writing, replacing any file with that name.
+	 */
+	explicit QueryLog(const std::string &filename);
+
+	bool isOpen() const;
+
+	/**
+	 * @brief Appends a route plan, stamped with the current time.
+	 */
+	void record(const RoutePlan &routePlan);
+
+private:
+	std::mutex mutex;
+	std::ofstream file;
+	std::chrono::steady_clock::time_point origin;
+};
+
+/**
+ * @brief A route plan read back from a query log.
+ */
+struct LoggedQuery {
+	long offset;
+	RoutePlan routePlan;
+};
+
+/**
+ * @brief Sets the log that logQuery() records to; nullptr stops recording. The caller keeps ownership.
+ */
+void setQueryLog(QueryLog *log);
+
+/**
+ * @brief Records a route plan in the current query log, if there is one.
+ */
+void logQuery(const RoutePlan &routePlan);
+
+/**
+ * @brief Reads a query log.
+ *
+ * @param filename The path to the log.
+ * @return The logged queries, in log order (empty if the file could not be opened).
+ */
+std::vector<LoggedQuery> readQueryLog(const std::string &filename);
+
+#endif //QUERYLOG_H
@@ -0,0 +1,142 @@
+/**
+* @file replay.cpp
+ * @brief Load generator that replays a query log (see queryLog.h) against the route planner.
+ *
+ * Usage: `replay log [--map dir] [--threads N] [--original | --rate QPS] [--turns file] [--overlay]`
+ *
+ * Each thread has its own RoutingEngine (see routingCore.h), prepared as the main program prepares it, since answering
+ * a plan closes locations in the graph. The queries are handed out in log order and run at their original pacing
+ * (`--original`), at a fixed rate (`--rate`), or as fast as possible (the default). The latency of a paced query
+ * counts from the time it was due, so queueing behind slow queries is included. Throughput and latency
+ * percentiles are printed at the end; the results themselves are discarded.
+ */
+#include "routingCore.h"
+#include "queryLog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double percentile(const std::vector<double> &sorted, double p) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t rank = std::min(sorted.size() - 1, (size_t)(p / 100 * sorted.size()));
+	return sorted[rank];
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: replay log [--map dir] [--threads N] [--original | --rate QPS] [--turns file] [--overlay]"
+				  << std::endl;
+		return 1;
+	}
+
+	std::string mapDir = "smallSampleSize";
+	EngineOptions options;
+	unsigned threads = 1;
+	bool original = false;
+	double rate = 0;
+
+	for (int arg = 2; arg < argc; arg++) {
+		std::string option = argv[arg];
+
+		if (option == "--map" && arg + 1 < argc) {
+			mapDir = argv[++arg];
+		}
+		else if (option == "--threads" && arg + 1 < argc) {
+			threads = std::max(1, std::stoi(argv[++arg]));
+		}
+		else if (option == "--original") {
+			original = true;
+		}
+		else if (option == "--rate" && arg + 1 < argc) {
+			rate = std::stod(argv[++arg]);
+		}
+		else if (option == "--turns" && arg + 1 < argc) {
+			options.turnsFile = argv[++arg];
+		}
+		else if (option == "--overlay") {
+			options.overlay = true;
+		}
+	}
+
+	std::vector<LoggedQuery> queries = readQueryLog(argv[1]);
+	if (queries.empty()) {
+		std::cerr << "Error: No queries in log: " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::vector<std::unique_ptr<RoutingEngine>> engines;
+	for (unsigned t = 0; t < threads; t++) {
+		engines.emplace_back(new RoutingEngine(mapDir + "/Locations.csv", mapDir + "/Distances.csv", options));
+	}
+
+	// Time each query is due, relative to the start of the replay; negative when unpaced
+	std::vector<long> due(queries.size(), -1);
+	for (size_t i = 0; i < queries.size(); i++) {
+		if (original) {
+			due[i] = queries[i].offset - queries[0].offset;
+		}
+		else if (rate > 0) {
+			due[i] = (long)(i * 1e6 / rate);
+		}
+	}
+
+	std::vector<double> latency(queries.size());
+	std::atomic<size_t> next{0};
+	Clock::time_point start = Clock::now();
+
+	auto worker = [&](RoutingEngine *engine) {
+		for (size_t i = next++; i < queries.size(); i = next++) {
+			Clock::time_point begin = Clock::now();
+			if (due[i] >= 0) {
+				begin = start + std::chrono::microseconds(due[i]);
+				std::this_thread::sleep_until(begin);
+			}
+
+			std::ostringstream out;
+			printPlanResult(queries[i].routePlan, engine->plan(queries[i].routePlan), out);
+			latency[i] = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < threads; t++) {
+		pool.emplace_back(worker, engines[t].get());
+	}
+	worker(engines[0].get());
+	for (auto &t : pool) {
+		t.join();
+	}
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	std::sort(latency.begin(), latency.end());
+
+	std::cout << "Queries:" << queries.size() << std::endl;
+	std::cout << "Threads:" << threads << std::endl;
+	if (original) {
+		std::cout << "Pacing:original" << std::endl;
+	}
+	else if (rate > 0) {
+		std::cout << "Pacing:" << rate << " queries/s" << std::endl;
+	}
+	else {
+		std::cout << "Pacing:none" << std::endl;
+	}
+	std::cout << "Elapsed:" << elapsed << " s" << std::endl;
+	std::cout << "Throughput:" << queries.size() / elapsed << " queries/s" << std::endl;
+	std::cout << "LatencyP50:" << percentile(latency, 50) << " ms" << std::endl;
+	std::cout << "LatencyP90:" << percentile(latency, 90) << " ms" << std::endl;
+	std::cout << "LatencyP99:" << percentile(latency, 99) << " ms" << std::endl;
+	std::cout << "LatencyMax:" << latency.back() << " ms" << std::endl;
+
+	return 0;
+}
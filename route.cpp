@@ -1,6 +1,14 @@
 #include "route.h"
+#include "trace.h"
+#include <algorithm>
+
+void printRoute(const Route &route, std::ostream& out) {
+	TraceSpan span("printRoute");
+	if (route.time == ROUTE_TIMED_OUT) {
+		out << "timeout" << std::endl;
+		return;
+	}
 
-void printRoute(Route &route, std::ostream& out) {
 	if (route.time < 0) {
 		out << "none" << std::endl;
 		return;
@@ -17,8 +25,13 @@ void printRoute(Route &route, std::ostream& out) {
     out << "(" << route.time << ")" << std::endl;
 }
 
+void printBound(const Route &route, std::ostream& out) {
+	out << "Bound:" << route.bound << std::endl;
+}
+
 void mergeRoutes(Route &route1, const Route &route2) {
 	route1.time += route2.time;
+	route1.bound = std::max(route1.bound, route2.bound);
 	route1.length = route1.length + route2.length - 1;
 
 	for (int i = 1; i < route2.length; i++) {
@@ -11,31 +11,47 @@
 #include <vector>
 #include <iostream>
 
+// Time of a route whose search was stopped by the query deadline
+const int ROUTE_TIMED_OUT = -2;
+
 /**
  * @struct Route
  * @brief Represents a route with a sequence of locations and travel time.
  *
  * This structure holds the locations of a route (as indices), the number of locations in the route,
- * and the total time taken for the route.
+ * and the total time taken for the route. The time is at most bound times the best possible one; the bound
+ * is 1 unless the route comes from a bounded-suboptimal search. A time of -1 means there is no route, and
+ * ROUTE_TIMED_OUT that the search ran out of time.
  */
 struct Route {
   std::vector<int> r;
   int length;
   int time;
+  double bound = 1;
 };
 
 /**
  * @brief Prints a route to the specified output stream.
  *
+ * A missing route is printed as `none`, and one whose search ran out of time as `timeout`.
+ *
  * @param route The route to be printed.
  * @param out The output stream to print to.
  */
-void printRoute(Route &route, std::ostream& out);
+void printRoute(const Route &route, std::ostream& out);
+
+/**
+ * @brief Prints the suboptimality bound of a route to the specified output stream.
+ *
+ * @param route The route whose bound is printed.
+ * @param out The output stream to print to.
+ */
+void printBound(const Route &route, std::ostream& out);
 
 /**
  * @brief Merges two routes into one.
  *
- * The second route is appended to the first route, and the total time is updated.
+ * The second route is appended to the first route, and the total time and bound are updated.
  *
  * @param route1 The first route to be updated.
  * @param route2 The second route to be merged into the first.
@@ -0,0 +1,87 @@
+#include "routingCore.h"
+#include "dataParser.h"
+#include "vertexOrder.h"
+#include "allPairs.h"
+#include "parkingIndex.h"
+#include "turns.h"
+#include "components.h"
+#include "biconnectivity.h"
+#include "landmarks.h"
+#include "partitionOverlay.h"
+
+// Reordering drops anything precomputed before it, so it comes first
+
+RoutingEngine::RoutingEngine(const std::string &locationsFile, const std::string &distancesFile,
+							 const EngineOptions &options) : graph(new Graph()), options(options) {
+	fileToGraph(graph, locationsFile, distancesFile);
+
+	if (options.reorder) {
+		reorderForLocality(graph);
+	}
+	if (!options.turnsFile.empty()) {
+		loadTurns(graph, options.turnsFile);
+	}
+	if (options.overlay) {
+		precomputeOverlay(graph);
+	}
+
+	prepare(true);
+	enableTreeCache(graph, options.treeCacheMiB << 20);
+}
+
+// Everything the weights change, which a weight update drops. The overlay keeps its partition and is only customized
+// again. The all-pairs file holds the matrices of the map as loaded, so it no longer applies after an update
+
+void RoutingEngine::prepare(bool useAllPairsFile) {
+	if (options.allPairs) {
+		bool useFile = useAllPairsFile && !options.allPairsFile.empty();
+		if (!useFile || !loadAllPairs(graph, options.allPairsFile)) {
+			precomputeAllPairs(graph);
+			if (useFile) {
+				saveAllPairs(graph, options.allPairsFile);
+			}
+		}
+	}
+	if (options.parkingRadius >= 0) {
+		precomputeParkingIndex(graph, options.parkingRadius);
+	}
+	OverlayGraph *overlay = graph->getOverlay();
+	if (overlay != nullptr && !overlay->isCustomized()) {
+		overlay->customize(Metric::Driving);
+	}
+
+	precomputeComponents(graph);
+	precomputeBiconnectivity(graph);
+	precomputeLandmarks(graph);
+}
+
+void RoutingEngine::refresh() {
+	if (weightsChanged) {
+		prepare(false);
+		weightsChanged = false;
+	}
+}
+
+RoutingEngine::~RoutingEngine() {
+	delete graph;
+}
+
+PlanResult RoutingEngine::plan(const RoutePlan &routePlan) {
+	refresh();
+	PlanResult result = planRoute(graph, routePlan);
+	graph->reopenAll();
+	return result;
+}
+
+bool RoutingEngine::setSegmentWeights(int id1, int id2, int driving, int walking) {
+	if (!graph->setSegmentWeights(id1, id2, driving, walking)) {
+		return false;
+	}
+	weightsChanged = true;
+	return true;
+}
+
+Graph *RoutingEngine::getGraph() {
+	refresh();
+	return graph;
+}
@@ -0,0 +1,96 @@
+/**
+* @file routingCore.h
+ * @brief Embeddable route planning API: a loaded map and its precomputed data, answering route plans with
+ * structured results and no I/O.
+ */
+
+#ifndef ROUTINGCORE_H
+#define ROUTINGCORE_H
+
+#include <cstddef>
+#include <string>
+#include "Graph.h"
+#include "inputHandler.h"
+#include "algorithms.h"
+#include "treeCache.h"
+
+/**
+ * @struct EngineOptions
+ * @brief What a RoutingEngine precomputes after loading its map. The defaults are what the main program uses.
+ *
+ * reorder renumbers the vertices for locality (see reorderForLocality()). allPairs precomputes the all-pairs matrices,
+ * loaded from allPairsFile when it matches the map and saved to it otherwise. A parkingRadius of zero or more builds the
+ * parking index with that walking radius, in minutes. turnsFile holds the turn restrictions and penalties to load (see
+ * loadTurns()), and treeCacheMiB is the capacity of the tree cache. overlay partitions the map and customizes it for
+ * driving (see partitionOverlay.h), which then answers the driving plans with avoided locations or segments.
+ */
+struct EngineOptions {
+	bool reorder = false;
+	bool allPairs = false;
+	std::string allPairsFile;
+	int parkingRadius = -1;
+	std::string turnsFile;
+	size_t treeCacheMiB = DEFAULT_TREE_CACHE_MIB;
+	bool overlay = false;
+};
+
+/**
+ * @brief A loaded map, prepared once, that answers route plans.
+ *
+ * The map is prepared in a fixed order, whatever options are set: reordering, turns, overlay, all-pairs matrices,
+ * parking index, then the connected components, biconnectivity, landmarks and tree cache every query relies on.
+ *
+ * Answering a plan closes locations in the graph, so an engine answers one plan at a time; threads that plan
+ * concurrently each need an engine of their own.
+ */
+class RoutingEngine {
+public:
+	/**
+	 * @brief Loads a map from its CSV files and prepares it.
+	 *
+	 * @param locationsFile The path to the locations file.
+	 * @param distancesFile The path to the distances file.
+	 * @param options What to precompute.
+	 */
+	RoutingEngine(const std::string &locationsFile, const std::string &distancesFile,
+				  const EngineOptions &options = EngineOptions());
+
+	~RoutingEngine();
+
+	RoutingEngine(const RoutingEngine &) = delete;
+	RoutingEngine &operator=(const RoutingEngine &) = delete;
+
+	/**
+	 * @brief Answers a route plan (see planRoute()). The graph is left as loaded afterwards.
+	 *
+	 * @param routePlan The route plan.
+	 * @return The structured result, which printPlanResult() prints in the output file format.
+	 */
+	PlanResult plan(const RoutePlan &routePlan);
+
+	/**
+	 * @brief Changes the driving and walking times of a segment, in both directions (see Graph::setSegmentWeights()).
+	 *
+	 * The data that depends on the weights is prepared again, once, before the next plan: the overlay is customized
+	 * again on its partition, and the all-pairs matrices are computed rather than loaded from allPairsFile.
+	 *
+	 * @return False if no such segment exists.
+	 */
+	bool setSegmentWeights(int id1, int id2, int driving, int walking);
+
+	/**
+	 * @brief The prepared graph, for the functions that take one directly (e.g. runBatch()). It stays owned by the
+	 * engine.
+	 */
+	Graph *getGraph();
+
+private:
+	void prepare(bool useAllPairsFile);
+	void refresh();
+
+	Graph *graph;
+	EngineOptions options;
+	bool weightsChanged = false;
+};
+
+#endif //ROUTINGCORE_H
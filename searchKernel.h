@@ -0,0 +1,303 @@
+/**
+* @file searchKernel.h
+ * @brief Dijkstra search kernel parameterized at compile time by weight, filter, termination and instrumentation.
+ *
+ * Every policy is a small type whose calls are resolved and inlined when the kernel is instantiated, so a
+ * search pays nothing for the policies it does not use. The kernel keeps its distances and parents in a search
+ * state: VertexSearchState writes them into the vertexes, as dijkstraDriving() and dijkstraWalking() do, and
+ * SearchBuffers keeps them in buffers owned by the caller, which a worker thread or a resumable search reuses
+ * between queries.
+ */
+
+#ifndef SEARCHKERNEL_H
+#define SEARCHKERNEL_H
+
+#include <climits>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "MutablePriorityQueue.h"
+#include "deadline.h"
+#include "trace.h"
+
+// ---------------------------------------- Weight policies ------------------------------------------------------- //
+
+/**
+ * @brief Driving time of an edge; INT_MAX (segments marked `X`) means the edge cannot be used.
+ */
+struct DrivingWeight {
+	static long weight(const Edge *edge) { return edge->getDriving(); }
+};
+
+/**
+ * @brief Walking time of an edge.
+ */
+struct WalkingWeight {
+	static long weight(const Edge *edge) { return edge->getWalking(); }
+};
+
+// ---------------------------------------- Filter policies ------------------------------------------------------- //
+
+/**
+ * @brief Relaxes every open edge.
+ */
+struct AllEdges {
+	bool operator()(const Edge *, long) const { return true; }
+};
+
+/**
+ * @brief Relaxes only the edges that leave the tentative distance within the bound, so no vertex beyond it is
+ * ever queued.
+ */
+struct WithinBound {
+	long bound;
+
+	bool operator()(const Edge *, long dist) const { return dist <= bound; }
+};
+
+// ---------------------------------------- Termination policies -------------------------------------------------- //
+
+/**
+ * @brief Settles every reachable vertex.
+ */
+struct Exhaustive {
+	template <typename State>
+	bool operator()(const State &) const { return false; }
+};
+
+/**
+ * @brief Stops once the target (by dense index) is settled and its edges relaxed, so the search can be resumed.
+ */
+struct StopAtTarget {
+	int target;
+
+	template <typename State>
+	bool operator()(const State &state) const { return state.isSettled(target); }
+};
+
+// ---------------------------------------- Instrumentation policies ---------------------------------------------- //
+
+/**
+ * @brief Records nothing.
+ */
+struct NoInstrumentation {
+	void settled(int, long, const Edge *) {}
+};
+
+// ---------------------------------------- Search states --------------------------------------------------------- //
+
+/**
+ * @brief Search state kept in the vertexes: getDist() (INT_MAX if not reached), getPath() and isVisited().
+ *
+ * Creating it resets every vertex, in O(V).
+ */
+class VertexSearchState {
+public:
+	explicit VertexSearchState(const Graph *graph) : vertices(graph->getVertexSet()) {
+		// queueIndex is reset too, since a search that stopped early leaves vertexes in its queue
+		for (auto v : vertices) {
+			v->setDist(INT_MAX);
+			v->setVisited(false);
+			v->setPath(nullptr);
+			v->queueIndex = 0;
+		}
+	}
+
+	void start(int source) {
+		vertices[source]->setDist(0);
+		queue.insert(vertices[source]);
+	}
+
+	bool empty() { return queue.empty(); }
+
+	int pop() {
+		Vertex *v = queue.extractMin();
+		v->setVisited(true);
+		return v->getIndex();
+	}
+
+	long dist(int v) const { return vertices[v]->getDist(); }
+	bool isSettled(int v) const { return vertices[v]->isVisited(); }
+	Edge *parent(int v) const { return vertices[v]->getPath(); }
+
+	void relax(int v, long dist, Edge *parent) {
+		Vertex *u = vertices[v];
+		u->setDist(dist);
+		u->setPath(parent);
+		if (u->queueIndex == 0) {
+			queue.insert(u);
+		}
+		else {
+			queue.decreaseKey(u);
+		}
+	}
+
+private:
+	const std::vector<Vertex *> &vertices;
+	MutablePriorityQueue<Vertex> queue;
+};
+
+/**
+ * @brief Potential of the plain Dijkstra order.
+ */
+struct NoPotential {
+	long operator()(int) const { return 0; }
+};
+
+/**
+ * @brief Search state in buffers owned by the caller; only the entries a search touched are reset by the next one.
+ *
+ * Vertexes are queued by distance plus potential, so a potential that bounds the remaining distance from below
+ * turns the search into A*. A settled vertex is never reopened.
+ *
+ * @tparam Potential `operator()(int)`, the potential of a vertex by dense index.
+ */
+template <typename Potential = NoPotential>
+class SearchBuffers {
+public:
+	explicit SearchBuffers(int n, Potential potential = Potential()) : potential(potential), distances(n, INT_MAX),
+		parents(n, nullptr), settled(n, false) {}
+
+	/**
+	 * @brief Forgets the previous search, in time proportional to the vertexes it touched.
+	 */
+	void clear() {
+		for (int v : touched) {
+			distances[v] = INT_MAX;
+			parents[v] = nullptr;
+			settled[v] = false;
+		}
+		touched.clear();
+		queue = {};
+	}
+
+	/**
+	 * @brief Clears the buffers and queues the source (by dense index) at distance 0.
+	 */
+	void start(int source) {
+		clear();
+		distances[source] = 0;
+		touched.push_back(source);
+		queue.emplace(potential(source), source);
+	}
+
+	bool empty() const { return queue.empty(); }
+
+	// Settles the next vertex, or returns -1 for an entry left behind by a shorter distance
+	int pop() {
+		int v = queue.top().second;
+		queue.pop();
+		if (settled[v]) {
+			return -1;
+		}
+		settled[v] = true;
+		return v;
+	}
+
+	long dist(int v) const { return distances[v]; }
+	bool isSettled(int v) const { return settled[v]; }
+	Edge *parent(int v) const { return parents[v]; }
+
+	void relax(int v, long dist, Edge *parent) {
+		if (distances[v] == INT_MAX) {
+			touched.push_back(v);
+		}
+		distances[v] = dist;
+		parents[v] = parent;
+		queue.emplace(dist + potential(v), v);
+	}
+
+private:
+	using Key = decltype(std::declval<const Potential &>()(0) + 0L);
+	using Entry = std::pair<Key, int>;
+
+	Potential potential;
+	std::vector<long> distances;
+	std::vector<Edge *> parents;
+	std::vector<bool> settled;
+	std::vector<int> touched;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+};
+
+// ---------------------------------------- Kernel ---------------------------------------------------------------- //
+
+/**
+ * @brief Runs Dijkstra on a started search state until the termination rule holds or the queue is empty.
+ *
+ * The search also stops when the current query deadline expires (see deadline.h). The deadline is polled between
+ * vertexes, so the state stays consistent and the search can be resumed by running the kernel again. The time
+ * complexity is O((V + E) log V).
+ *
+ * @tparam Weight Weight policy: `static long weight(const Edge *)`, INT_MAX for unusable edges.
+ * @tparam State Search state, VertexSearchState or SearchBuffers.
+ * @tparam Filter Filter policy: `bool operator()(const Edge *, long dist)`, false to skip an edge that would give
+ *         its destination the tentative distance dist.
+ * @tparam Termination Termination policy: `bool operator()(const State &)`, checked before each vertex, true to stop.
+ * @tparam Instrumentation Instrumentation policy: `settled(int v, long dist, const Edge *parent)`.
+ * @param graph The graph.
+ * @param state The search state, with its source already queued.
+ * @param filter The filter.
+ * @param termination The termination rule.
+ * @param instrumentation The instrumentation, which keeps what it recorded.
+ * @return False if the query deadline expired first.
+ */
+template <typename Weight, typename State, typename Filter = AllEdges, typename Termination = Exhaustive,
+		  typename Instrumentation = NoInstrumentation>
+bool searchKernel(const Graph *graph, State &state, const Filter &filter = Filter(),
+				  const Termination &termination = Termination(),
+				  Instrumentation &&instrumentation = Instrumentation()) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	DeadlinePoll interrupted;
+
+	while (!termination(state) && !state.empty()) {
+		if (interrupted()) {
+			return false;
+		}
+
+		int v = state.pop();
+		if (v == -1) {
+			continue;
+		}
+		long d = state.dist(v);
+		instrumentation.settled(v, d, state.parent(v));
+
+		for (auto e : vertices[v]->getAdj()) {
+			long weight = Weight::weight(e);
+			int u = e->getDest()->getIndex();
+
+			if (weight == INT_MAX || state.isSettled(u) || d + weight >= state.dist(u) || !filter(e, d + weight)) {
+				continue;
+			}
+			state.relax(u, d + weight, e);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Runs Dijkstra from a source, leaving the distances and parent edges in the vertexes.
+ *
+ * The results are read as after dijkstraDriving(): getDist() (INT_MAX if not reached) and getPath(). If the
+ * query deadline expires, only the settled vertices (isVisited()) have final distances.
+ *
+ * @tparam Weight Weight policy.
+ * @param graph The graph.
+ * @param source The ID of the source location.
+ */
+template <typename Weight>
+void dijkstraSearch(Graph *graph, int source) {
+	TraceSpan span("dijkstra");
+	Vertex *src = graph->findVertexById(source);
+
+	if (!src) {
+		return;
+	}
+
+	VertexSearchState state(graph);
+	state.start(src->getIndex());
+	searchKernel<Weight>(graph, state);
+}
+
+#endif //SEARCHKERNEL_H
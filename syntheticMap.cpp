@@ -0,0 +1,30 @@
+#include "syntheticMap.h"
+#include <random>
+#include <string>
+
+void syntheticGrid(Graph *graph, int side, unsigned seed) {
+	std::mt19937 rng(seed);
+	auto code = [](int v) { return "C" + std::to_string(v); };
+	auto addSegment = [&](int a, int b, int driving) {
+		graph->addBidirectionalEdge(code(a), code(b), driving, 5 * driving);
+	};
+
+	for (int v = 0; v < side * side; v++) {
+		graph->addVertex("L" + std::to_string(v), v, code(v), v % 10 == 0);
+	}
+
+	for (int r = 0; r < side; r++) {
+		for (int c = 0; c < side; c++) {
+			int v = r * side + c;
+			if (c + 1 < side && rng() % 10 != 0) {
+				addSegment(v, v + 1, 1 + rng() % 20);
+			}
+			if (r + 1 < side && rng() % 10 != 0) {
+				addSegment(v, v + side, 1 + rng() % 20);
+			}
+			if (r + 5 < side && c + 5 < side && rng() % 50 == 0) {
+				addSegment(v, v + 5 * side + 5, 10 + rng() % 20);
+			}
+		}
+	}
+}
@@ -0,0 +1,25 @@
+/**
+* @file syntheticMap.h
+ * @brief Random grid maps of any size, for benchmarks and checks beyond the sample maps.
+ */
+
+#ifndef SYNTHETICMAP_H
+#define SYNTHETICMAP_H
+
+#include "Graph.h"
+
+/**
+ * @brief Fills an empty graph with a side x side grid of locations.
+ *
+ * Location r * side + c has that number as its ID, `C` followed by it as its code, and a parking spot when the
+ * number is a multiple of 10. About 90% of the segments between horizontal and vertical neighbours exist, with a
+ * driving time from 1 to 20 and a walking time five times longer; one location in 50 also gets a slower diagonal
+ * segment five rows and columns away. The same side and seed always give the same map.
+ *
+ * @param graph The graph, which must be empty.
+ * @param side The number of rows and columns.
+ * @param seed The seed of the random generator.
+ */
+void syntheticGrid(Graph *graph, int side, unsigned seed);
+
+#endif //SYNTHETICMAP_H
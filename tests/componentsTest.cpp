@@ -0,0 +1,110 @@
+/**
+* @file componentsTest.cpp
+ * @brief Checks the incremental component labels (see components.h) against labels rebuilt from scratch.
+ *
+ * Usage: `componentsTest [mapDir]`
+ *
+ * 3000 random closures and reopenings of locations and segments, with a few full reopenings, are applied to the
+ * graph, which keeps its ComponentIndex up to date through split() and merge(). After every few of them the kept
+ * labels must give the same partition as a new ComponentIndex, for both metrics. Exits with 1 on the first mismatch.
+ */
+#include "Graph.h"
+#include "components.h"
+#include "dataParser.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+static const int OPERATIONS = 3000;
+static const int CHECK_INTERVAL = 10;
+
+// The partitions agree if they have as many components and every open location is in the kept component of the
+// first location of its fresh component: each fresh component then lies in a kept one, and the counts match
+
+static bool samePartition(const Graph &graph, const ComponentIndex &fresh, const ComponentIndex &kept,
+						  Metric metric) {
+	if (fresh.getNumComponents(metric) != kept.getNumComponents(metric)) {
+		return false;
+	}
+
+	std::vector<const Vertex *> firsts;
+	for (auto v : graph.getVertexSet()) {
+		if (v->isClosed()) {
+			continue;
+		}
+
+		const Vertex *first = nullptr;
+		for (auto f : firsts) {
+			if (fresh.connected(metric, f, v)) {
+				first = f;
+				break;
+			}
+		}
+
+		if (first == nullptr) {
+			firsts.push_back(v);
+		}
+		else if (!kept.connected(metric, first, v)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	std::string mapDir = argc > 1 ? argv[1] : "largeSampleSize";
+	Graph graph;
+	fileToGraph(&graph, mapDir + "/Locations.csv", mapDir + "/Distances.csv");
+	precomputeComponents(&graph);
+
+	const std::vector<Vertex *> &vertices = graph.getVertexSet();
+	std::mt19937 rng(4);
+	auto randomVertex = [&]() { return vertices[rng() % vertices.size()]; };
+	std::vector<std::pair<int, int>> closedSegments;
+
+	for (int step = 1; step <= OPERATIONS; step++) {
+		int operation = rng() % 10;
+		Vertex *v = randomVertex();
+
+		if (operation < 4) {
+			graph.closeVertex(v->getId());
+		}
+		else if (operation < 8) {
+			if (!v->getAdj().empty()) {
+				int id = v->getAdj()[rng() % v->getAdj().size()]->getDest()->getId();
+				graph.closeSegment(v->getId(), id);
+				closedSegments.emplace_back(v->getId(), id);
+			}
+		}
+		else if (operation < 9) {
+			graph.reopenVertex(v->getId());
+		}
+		else if (!closedSegments.empty() && rng() % 20 != 0) {
+			std::swap(closedSegments[rng() % closedSegments.size()], closedSegments.back());
+			graph.reopenSegment(closedSegments.back().first, closedSegments.back().second);
+			closedSegments.pop_back();
+		}
+		else {
+			graph.reopenAll();
+			closedSegments.clear();
+		}
+
+		if (step % CHECK_INTERVAL != 0) {
+			continue;
+		}
+
+		ComponentIndex fresh(&graph);
+		for (Metric metric : {Metric::Driving, Metric::Walking}) {
+			if (!samePartition(graph, fresh, *graph.getComponents(), metric)) {
+				std::cerr << "Components differ from a rebuild after " << step << " operations ("
+						  << (metric == Metric::Driving ? "driving" : "walking") << ")" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	std::cout << OPERATIONS << " operations checked against rebuilt labels" << std::endl;
+	return 0;
+}
@@ -0,0 +1,105 @@
+/**
+* @file hubLabelsTest.cpp
+ * @brief Checks the hub label distances and routes (see hubLabels.h) against Dijkstra.
+ *
+ * Usage: `hubLabelsTest [mapDir]`
+ *
+ * The labels are built for both metrics of the map, with a few locations closed, and for the driving metric of a
+ * synthetic grid (see syntheticMap.h). From 20 random sources, the label distance to every location must equal
+ * the Dijkstra distance, and the route to a random destination must run between the endpoints over existing
+ * segments whose times add up to that distance. Exits with 1 on the first mismatch.
+ */
+#include "Graph.h"
+#include "algorithms.h"
+#include "dataParser.h"
+#include "hubLabels.h"
+#include "syntheticMap.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int SOURCES = 20;
+static const int CLOSED_LOCATIONS = 10;
+static const int GRID_SIDE = 50;
+
+// Time of the cheapest open segment between two consecutive route locations, INT_MAX if there is none
+
+static long segmentTime(const Graph &graph, Metric metric, int from, int to) {
+	long best = INT_MAX;
+	for (auto e : graph.findVertexById(from)->getAdj()) {
+		if (e->getDest()->getId() == to) {
+			best = std::min(best, (long)e->getWeight(metric));
+		}
+	}
+	return best;
+}
+
+static bool check(Graph &graph, Metric metric, const std::string &name, std::mt19937 &rng) {
+	HubLabels labels(&graph, metric);
+	const std::vector<Vertex *> &vertices = graph.getVertexSet();
+	int n = vertices.size();
+
+	for (int i = 0; i < SOURCES; i++) {
+		Vertex *source = vertices[rng() % n];
+		if (metric == Metric::Driving) {
+			dijkstraDriving(&graph, source->getId());
+		}
+		else {
+			dijkstraWalking(&graph, source->getId());
+		}
+
+		for (auto v : vertices) {
+			if (labels.distance(source->getId(), v->getId()) != v->getDist()) {
+				std::cerr << name << ": distance from " << source->getId() << " to " << v->getId() << " is "
+						  << labels.distance(source->getId(), v->getId()) << ", Dijkstra gives " << v->getDist()
+						  << std::endl;
+				return false;
+			}
+		}
+
+		Vertex *destination = vertices[rng() % n];
+		Route route = labels.route(source->getId(), destination->getId());
+		long expected = destination->getDist() == INT_MAX ? -1 : destination->getDist();
+		bool valid = route.time == expected;
+
+		if (valid && route.time >= 0) {
+			long total = 0;
+			for (int j = 0; j + 1 < route.length && total < INT_MAX; j++) {
+				total += segmentTime(graph, metric, route.r[j], route.r[j + 1]);
+			}
+			valid = route.length > 0 && route.r.front() == source->getId() && route.r.back() == destination->getId()
+				&& total == expected;
+		}
+		if (!valid) {
+			std::cerr << name << ": bad route from " << source->getId() << " to " << destination->getId()
+					  << " (time " << route.time << ", Dijkstra gives " << expected << ")" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	std::string mapDir = argc > 1 ? argv[1] : "largeSampleSize";
+	std::mt19937 rng(3);
+
+	Graph map;
+	fileToGraph(&map, mapDir + "/Locations.csv", mapDir + "/Distances.csv");
+	for (int i = 0; i < CLOSED_LOCATIONS; i++) {
+		map.closeVertex(map.getVertexSet()[rng() % map.getNumVertex()]->getId());
+	}
+
+	Graph grid;
+	syntheticGrid(&grid, GRID_SIDE, 1);
+
+	if (!check(map, Metric::Driving, "driving", rng) || !check(map, Metric::Walking, "walking", rng)
+		|| !check(grid, Metric::Driving, "grid", rng)) {
+		return 1;
+	}
+
+	std::cout << "Hub labels match Dijkstra" << std::endl;
+	return 0;
+}
@@ -0,0 +1,169 @@
+/**
+* @file turnsTest.cpp
+ * @brief Checks the turn-aware driving routes (see turns.h) against a Dijkstra over the full line graph.
+ *
+ * Usage: `turnsTest [mapDir]`
+ *
+ * Random penalties and bans are put on a third of the junctions of the map, and a few locations are closed. For
+ * 200 random pairs and 100 random fixed-order triples of stops, turnAwareRoute() must find the time of a reference
+ * search whose states are every (previous location, location, stops visited), and its route must take no banned
+ * turn and add up to that time. Exits with 1 on the first mismatch.
+ */
+#include "Graph.h"
+#include "dataParser.h"
+#include "turns.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static const int PAIRS = 200;
+static const int STOP_ROUTES = 100;
+static const int CLOSED_LOCATIONS = 10;
+
+// Best time from the source through the stops in order over (previous, current, stops visited) states, -1 if none
+
+static long lineGraphTime(const Graph &graph, const TurnTable &turns, int source, const std::vector<int> &stops) {
+	auto advance = [&](int stage, int id) {
+		while (stage < (int)stops.size() && stops[stage] == id) {
+			stage++;
+		}
+		return stage;
+	};
+
+	using State = std::tuple<int, int, int>;
+	std::map<State, long> dist;
+	std::priority_queue<std::pair<long, State>, std::vector<std::pair<long, State>>,
+		std::greater<std::pair<long, State>>> queue;
+	auto relax = [&](const State &state, long d) {
+		auto it = dist.find(state);
+		if (it == dist.end() || d < it->second) {
+			dist[state] = d;
+			queue.push({d, state});
+		}
+	};
+
+	int first = advance(0, source);
+	if (first == (int)stops.size()) {
+		return 0;
+	}
+	for (auto e : graph.findVertexById(source)->getAdj()) {
+		if (e->getDriving() != INT_MAX) {
+			int to = e->getDest()->getId();
+			relax({source, to, advance(first, to)}, e->getDriving());
+		}
+	}
+
+	while (!queue.empty()) {
+		auto [d, state] = queue.top();
+		queue.pop();
+		auto [from, via, stage] = state;
+		if (d > dist[state]) {
+			continue;
+		}
+		if (stage == (int)stops.size()) {
+			return d;
+		}
+
+		for (auto e : graph.findVertexById(via)->getAdj()) {
+			int to = e->getDest()->getId();
+			int penalty = turns.penalty(from, via, to);
+			if (e->getDriving() != INT_MAX && penalty != TURN_BANNED) {
+				relax({via, to, advance(stage, to)}, d + e->getDriving() + penalty);
+			}
+		}
+	}
+	return -1;
+}
+
+// Time of a route with its turn penalties, -1 if it uses a missing segment or makes a banned turn
+
+static long routeTime(const Graph &graph, const TurnTable &turns, const Route &route) {
+	long total = 0;
+	for (int i = 0; i + 1 < route.length; i++) {
+		long segment = INT_MAX;
+		for (auto e : graph.findVertexById(route.r[i])->getAdj()) {
+			if (e->getDest()->getId() == route.r[i + 1]) {
+				segment = std::min(segment, (long)e->getDriving());
+			}
+		}
+		int penalty = i > 0 ? turns.penalty(route.r[i - 1], route.r[i], route.r[i + 1]) : 0;
+		if (segment == INT_MAX || penalty == TURN_BANNED) {
+			return -1;
+		}
+		total += segment + penalty;
+	}
+	return total;
+}
+
+static bool check(const Graph &graph, const TurnTable &turns, int source, const std::vector<int> &stops) {
+	Route route = stops.size() == 1 ? turnAwareRoute(&graph, turns, source, stops[0])
+									: turnAwareRoute(&graph, turns, source, stops);
+	long expected = lineGraphTime(graph, turns, source, stops);
+
+	bool valid = route.time == expected;
+	if (valid && route.time >= 0) {
+		valid = route.length > 0 && route.r.front() == source && route.r.back() == stops.back()
+			&& routeTime(graph, turns, route) == expected;
+	}
+	if (!valid) {
+		std::cerr << "Route from " << source << " through " << stops.size() << " stops to " << stops.back()
+				  << " has time " << route.time << ", the line graph gives " << expected << std::endl;
+	}
+	return valid;
+}
+
+int main(int argc, char *argv[]) {
+	std::string mapDir = argc > 1 ? argv[1] : "largeSampleSize";
+	Graph graph;
+	fileToGraph(&graph, mapDir + "/Locations.csv", mapDir + "/Distances.csv");
+
+	const std::vector<Vertex *> &vertices = graph.getVertexSet();
+	int n = vertices.size();
+	std::mt19937 rng(5);
+
+	TurnTable turns;
+	for (int i = 0; i < n / 3; i++) {
+		Vertex *via = vertices[rng() % n];
+		const std::vector<Edge *> &adj = via->getAdj();
+		if (adj.size() < 2) {
+			continue;
+		}
+		int from = adj[rng() % adj.size()]->getDest()->getId();
+		int to = adj[rng() % adj.size()]->getDest()->getId();
+		turns.add(from, via->getId(), to, rng() % 3 == 0 ? TURN_BANNED : (int)(rng() % 20));
+	}
+
+	for (int i = 0; i < CLOSED_LOCATIONS; i++) {
+		graph.closeVertex(vertices[rng() % n]->getId());
+	}
+	auto openLocation = [&]() {
+		Vertex *v = vertices[rng() % n];
+		while (v->isClosed()) {
+			v = vertices[rng() % n];
+		}
+		return v->getId();
+	};
+
+	for (int i = 0; i < PAIRS; i++) {
+		int source = openLocation();
+		if (!check(graph, turns, source, {openLocation()})) {
+			return 1;
+		}
+	}
+	for (int i = 0; i < STOP_ROUTES; i++) {
+		int source = openLocation();
+		if (!check(graph, turns, source, {openLocation(), openLocation(), openLocation()})) {
+			return 1;
+		}
+	}
+
+	std::cout << turns.size() << " turn rules, " << PAIRS + STOP_ROUTES << " routes match the line graph" << std::endl;
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+	const char *name;
+	double start;
+	double duration;
+};
+
+// Spans of one thread; only that thread appends to it, so recording needs no lock
+struct TraceBuffer {
+	int thread;
+	std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> tracing{false};
+std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+// Buffers are shared with the registry, so the spans of threads that have exited are kept
+std::mutex registryMutex;
+std::vector<std::shared_ptr<TraceBuffer>> registry;
+
+double now() {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+TraceBuffer &threadBuffer() {
+	thread_local std::shared_ptr<TraceBuffer> buffer;
+	if (!buffer) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		buffer = std::make_shared<TraceBuffer>();
+		buffer->thread = registry.size() + 1;
+		registry.push_back(buffer);
+	}
+	return *buffer;
+}
+
+void writeEscaped(const char *text, std::ostream &out) {
+	for (; *text != '\0'; text++) {
+		if (*text == '"' || *text == '\\') {
+			out << '\\';
+		}
+		out << *text;
+	}
+}
+
+}
+
+TraceSpan::TraceSpan(const char *name) : name(nullptr), start(0) {
+	if (tracing.load(std::memory_order_relaxed)) {
+		this->name = name;
+		start = now();
+	}
+}
+
+TraceSpan::~TraceSpan() {
+	if (name != nullptr) {
+		double end = now();
+		threadBuffer().events.push_back({name, start, end - start});
+	}
+}
+
+void startTracing() {
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (auto &buffer : registry) {
+			buffer->events.clear();
+		}
+	}
+	origin = std::chrono::steady_clock::now();
+	tracing.store(true, std::memory_order_relaxed);
+}
+
+void stopTracing() {
+	tracing.store(false, std::memory_order_relaxed);
+}
+
+void writeTrace(std::ostream &out) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+	bool first = true;
+	for (auto &buffer : registry) {
+		if (!first) {
+			out << ",";
+		}
+		first = false;
+		out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread
+			<< ",\"args\":{\"name\":\"thread " << buffer->thread << "\"}}";
+
+		for (const TraceEvent &event : buffer->events) {
+			out << ",\n{\"name\":\"";
+			writeEscaped(event.name, out);
+			out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << event.start
+				<< ",\"dur\":" << event.duration << "}";
+		}
+	}
+
+	out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+	out.flags(flags);
+	out.precision(precision);
+}
+
+bool saveTrace(const std::string &filename) {
+	std::ofstream file(filename);
+	if (!file.is_open()) {
+		return false;
+	}
+	writeTrace(file);
+	return true;
+}
@@ -0,0 +1,60 @@
+/**
+* @file trace.h
+ * @brief Timeline tracing: scoped spans recorded per thread and exported as Chrome trace events.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Records the time from its construction to its destruction as a span of the current thread.
+ *
+ * While tracing is off a span costs one atomic load. While it is on, it reads the clock twice and appends an
+ * entry to a buffer owned by its thread, without any lock. The name must outlive the trace, a string literal
+ * in practice.
+ */
+class TraceSpan {
+public:
+	explicit TraceSpan(const char *name);
+	~TraceSpan();
+
+	TraceSpan(const TraceSpan &) = delete;
+	TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+	const char *name;
+	double start;
+};
+
+/**
+ * @brief Starts recording spans, discarding any recorded before. Call it while no span is open.
+ */
+void startTracing();
+
+/**
+ * @brief Stops recording spans; those recorded are kept until the next startTracing().
+ */
+void stopTracing();
+
+/**
+ * @brief Writes the recorded spans as Chrome trace-event JSON (complete "X" events, times in microseconds).
+ *
+ * The output opens in chrome://tracing or Perfetto, one track per thread. It should be written once the traced
+ * work has finished, as threads still recording are not waited for.
+ *
+ * @param out The output stream to write to.
+ */
+void writeTrace(std::ostream &out);
+
+/**
+ * @brief Writes the recorded spans to a file (see writeTrace()).
+ *
+ * @param filename The path to the trace file.
+ * @return False if the file could not be opened.
+ */
+bool saveTrace(const std::string &filename);
+
+#endif //TRACE_H
@@ -0,0 +1,106 @@
+#include "treeCache.h"
+#include <algorithm>
+#include <climits>
+
+Route ShortestPathTree::route(const Graph *graph, int source, int destination) const {
+	Vertex *dest = graph->findVertexById(destination);
+	if (dest == nullptr || dist[dest->getIndex()] == INT_MAX) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<int> route;
+	for (Edge *cur = path[dest->getIndex()]; cur != nullptr; cur = path[cur->getOrig()->getIndex()]) {
+		route.push_back(cur->getDest()->getId());
+	}
+	route.push_back(source);
+	std::reverse(route.begin(), route.end());
+
+	return {route, (int)route.size(), (int)dist[dest->getIndex()]};
+}
+
+ShortestPathTreeCache::ShortestPathTreeCache(size_t capacity) : capacity(capacity) {}
+
+const ShortestPathTree *ShortestPathTreeCache::find(const Graph *graph, Metric metric, int source) {
+	auto it = index.find({source, metric, graph->getClosureKey()});
+	if (it == index.end()) {
+		misses++;
+		return nullptr;
+	}
+
+	hits++;
+	entries.splice(entries.begin(), entries, it->second);
+	return &it->second->tree;
+}
+
+void ShortestPathTreeCache::store(const Graph *graph, Metric metric, int source) {
+	Key key = {source, metric, graph->getClosureKey()};
+	size_t size = graph->getNumVertex() * (sizeof(long) + sizeof(Edge *));
+	if (size > capacity || index.count(key)) {
+		return;
+	}
+
+	while (used + size > capacity) {
+		used -= entries.back().tree.dist.size() * (sizeof(long) + sizeof(Edge *));
+		index.erase(entries.back().key);
+		entries.pop_back();
+	}
+
+	ShortestPathTree tree;
+	for (auto v : graph->getVertexSet()) {
+		tree.dist.push_back(v->getDist());
+		tree.path.push_back(v->getPath());
+	}
+
+	entries.push_front({key, std::move(tree)});
+	index[key] = entries.begin();
+	used += size;
+}
+
+void ShortestPathTreeCache::clear() {
+	entries.clear();
+	index.clear();
+	used = 0;
+}
+
+size_t ShortestPathTreeCache::memoryUsage() const {
+	return used;
+}
+
+long ShortestPathTreeCache::getHits() const {
+	return hits;
+}
+
+long ShortestPathTreeCache::getMisses() const {
+	return misses;
+}
+
+void enableTreeCache(Graph *graph, size_t capacity) {
+	graph->setTreeCache(capacity > 0 ? new ShortestPathTreeCache(capacity) : nullptr);
+}
+
+bool cachedSearch(Graph *graph, Metric metric, int source) {
+	const ShortestPathTree *tree = findCachedTree(graph, metric, source);
+	if (tree == nullptr) {
+		return false;
+	}
+
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	for (size_t v = 0; v < vertices.size(); v++) {
+		vertices[v]->setDist(tree->dist[v]);
+		vertices[v]->setVisited(tree->dist[v] != INT_MAX);
+		vertices[v]->setPath(tree->path[v]);
+	}
+	return true;
+}
+
+void cacheSearch(Graph *graph, Metric metric, int source) {
+	ShortestPathTreeCache *cache = graph->getTreeCache();
+	if (cache != nullptr && graph->findVertexById(source) != nullptr) {
+		cache->store(graph, metric, source);
+	}
+}
+
+const ShortestPathTree *findCachedTree(const Graph *graph, Metric metric, int source) {
+	ShortestPathTreeCache *cache = graph->getTreeCache();
+	return cache != nullptr ? cache->find(graph, metric, source) : nullptr;
+}
@@ -0,0 +1,123 @@
+/**
+* @file treeCache.h
+ * @brief Memory-bounded cache of completed one-to-all search results, shared by queries with the same root.
+ */
+
+#ifndef TREECACHE_H
+#define TREECACHE_H
+
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+
+// Default capacity of the cache, in MiB: about 3000 trees of the large map
+const size_t DEFAULT_TREE_CACHE_MIB = 64;
+
+/**
+ * @brief Distances and parent edges of a completed one-to-all search, by dense index.
+ */
+struct ShortestPathTree {
+	std::vector<long> dist;
+	std::vector<Edge *> path;
+
+	/**
+	 * @brief Reads the best route from the root of the tree to a location.
+	 *
+	 * @param graph The graph the tree was computed on.
+	 * @param source The ID of the root.
+	 * @param destination The ID of the destination location.
+	 * @return The route, with time -1 if there is none.
+	 */
+	Route route(const Graph *graph, int source, int destination) const;
+};
+
+/**
+ * @brief Least recently used cache of shortest path trees, keyed on root, metric and closures.
+ *
+ * The closures are identified by Graph::getClosureKey(), so a tree is only reused while exactly the same locations
+ * and segments are closed (for example, by batch plans with the same avoid lists). Each tree takes
+ * V * (sizeof(long) + sizeof(Edge *)) bytes; the least recently used ones are evicted to stay within the capacity.
+ */
+class ShortestPathTreeCache {
+public:
+	/**
+	 * @param capacity The maximum memory used by the trees, in bytes.
+	 */
+	explicit ShortestPathTreeCache(size_t capacity);
+
+	/**
+	 * @brief Finds the tree of a root for the current closures of the graph, marking it as recently used.
+	 *
+	 * @return The tree, or nullptr if it is not cached.
+	 */
+	const ShortestPathTree *find(const Graph *graph, Metric metric, int source);
+
+	/**
+	 * @brief Stores the search results currently held by the vertexes (as left by dijkstraDriving()).
+	 */
+	void store(const Graph *graph, Metric metric, int source);
+
+	void clear();
+	size_t memoryUsage() const;
+	long getHits() const;
+	long getMisses() const;
+
+private:
+	using Key = std::tuple<int, Metric, unsigned long long>;
+
+	struct Entry {
+		Key key;
+		ShortestPathTree tree;
+	};
+
+	size_t capacity;
+	size_t used = 0;
+	long hits = 0;
+	long misses = 0;
+
+	// Most recently used first
+	std::list<Entry> entries;
+	std::map<Key, std::list<Entry>::iterator> index;
+};
+
+/**
+ * @brief Gives the graph a shortest path tree cache, or removes it with a capacity of 0.
+ *
+ * The graph clears the cache whenever vertices, edges or weights change.
+ *
+ * @param graph The graph.
+ * @param capacity The maximum memory used by the trees, in bytes.
+ */
+void enableTreeCache(Graph *graph, size_t capacity);
+
+/**
+ * @brief Loads a cached tree into the vertexes, leaving the same results as dijkstraDriving() or
+ * dijkstraWalking() would.
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source location.
+ * @return False if the graph has no cache or the tree is not in it; the vertexes are then left untouched.
+ */
+bool cachedSearch(Graph *graph, Metric metric, int source);
+
+/**
+ * @brief Stores the results of a completed one-to-all search in the graph's cache, if it has one.
+ *
+ * @param graph The graph.
+ * @param metric The weight used by the search.
+ * @param source The ID of the source location of the search.
+ */
+void cacheSearch(Graph *graph, Metric metric, int source);
+
+/**
+ * @brief Finds the cached tree of a root for the current closures of the graph.
+ *
+ * @return The tree, or nullptr if the graph has no cache or the tree is not in it.
+ */
+const ShortestPathTree *findCachedTree(const Graph *graph, Metric metric, int source);
+
+#endif //TREECACHE_H
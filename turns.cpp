@@ -0,0 +1,193 @@
+#include "turns.h"
+#include "dataParser.h"
+#include "deadline.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+void TurnTable::add(int from, int via, int to, int penalty) {
+	std::vector<Rule> &junction = rules[via];
+	for (Rule &rule : junction) {
+		if (rule.from == from && rule.to == to) {
+			rule.penalty = penalty;
+			return;
+		}
+	}
+	junction.push_back({from, to, penalty});
+	count++;
+}
+
+bool TurnTable::hasRules(int via) const {
+	return rules.find(via) != rules.end();
+}
+
+int TurnTable::penalty(int from, int via, int to) const {
+	auto junction = rules.find(via);
+	if (junction == rules.end()) {
+		return 0;
+	}
+	for (const Rule &rule : junction->second) {
+		if (rule.from == from && rule.to == to) {
+			return rule.penalty;
+		}
+	}
+	return 0;
+}
+
+size_t TurnTable::size() const {
+	return count;
+}
+
+bool turnFree(const TurnTable &turns, const Route &route) {
+	for (int i = 1; i + 1 < route.length; i++) {
+		if (turns.penalty(route.r[i - 1], route.r[i], route.r[i + 1]) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * A state is a location with the edge the route arrived by (nullptr where that does not matter: at the source, and
+ * at locations that are not junctions with rules) and the number of stops the route has been through. States are
+ * numbered as they are first reached, and a junction's states are found by their arriving edge.
+ */
+
+Route turnAwareRoute(const Graph *graph, const TurnTable &turns, int source, const std::vector<int> &stops) {
+	TraceSpan span("turnAwareSearch");
+	Vertex *src = graph->findVertexById(source);
+	if (src == nullptr || stops.empty()) {
+		return {{}, 0, -1};
+	}
+	for (int stop : stops) {
+		if (graph->findVertexById(stop) == nullptr) {
+			return {{}, 0, -1};
+		}
+	}
+
+	// Stops reached by arriving at a location, from a count of stops already reached
+	int done = stops.size();
+	auto advance = [&](int stage, Vertex *v) {
+		while (stage < done && stops[stage] == v->getId()) {
+			stage++;
+		}
+		return stage;
+	};
+
+	std::vector<Vertex *> stateVertex;
+	std::vector<Edge *> stateEdge;
+	std::vector<int> stateStage;
+	std::vector<long> dist;
+	std::vector<int> parent;
+	std::vector<int> plainState((size_t)graph->getNumVertex() * (done + 1), -1);
+	std::vector<std::unordered_map<const Edge *, int>> junctionState(done + 1);
+
+	auto stateOf = [&](Vertex *v, Edge *arrival, int stage) {
+		int created = stateVertex.size();
+		int state;
+		if (arrival == nullptr) {
+			int &plain = plainState[(size_t)stage * graph->getNumVertex() + v->getIndex()];
+			if (plain == -1) {
+				plain = created;
+			}
+			state = plain;
+		}
+		else {
+			state = junctionState[stage].emplace(arrival, created).first->second;
+		}
+
+		if (state == created) {
+			stateVertex.push_back(v);
+			stateEdge.push_back(arrival);
+			stateStage.push_back(stage);
+			dist.push_back(LONG_MAX);
+			parent.push_back(-1);
+		}
+		return state;
+	};
+
+	using Entry = std::pair<long, int>;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	int first = stateOf(src, nullptr, advance(0, src));
+	dist[first] = 0;
+	queue.push({0, first});
+	DeadlinePoll interrupted;
+
+	int reached = -1;
+	while (!queue.empty()) {
+		auto [d, s] = queue.top();
+		queue.pop();
+		if (d > dist[s]) {
+			continue;
+		}
+
+		Vertex *v = stateVertex[s];
+		int stage = stateStage[s];
+		if (stage == done) {
+			reached = s;
+			break;
+		}
+
+		Edge *arrival = stateEdge[s];
+		for (Edge *e : v->getAdj()) {
+			if (interrupted()) {
+				return {{}, 0, ROUTE_TIMED_OUT};
+			}
+			if (e->getDriving() == INT_MAX) {
+				continue;
+			}
+
+			long penalty = 0;
+			if (arrival != nullptr) {
+				penalty = turns.penalty(arrival->getOrig()->getId(), v->getId(), e->getDest()->getId());
+				if (penalty == TURN_BANNED) {
+					continue;
+				}
+			}
+
+			Vertex *w = e->getDest();
+			int next = stateOf(w, turns.hasRules(w->getId()) ? e : nullptr, advance(stage, w));
+			if (d + e->getDriving() + penalty < dist[next]) {
+				dist[next] = d + e->getDriving() + penalty;
+				parent[next] = s;
+				queue.push({dist[next], next});
+			}
+		}
+	}
+
+	if (reached == -1) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<int> route;
+	for (int s = reached; s != -1; s = parent[s]) {
+		route.push_back(stateVertex[s]->getId());
+	}
+	std::reverse(route.begin(), route.end());
+	return {route, (int)route.size(), (int)dist[reached]};
+}
+
+Route turnAwareRoute(const Graph *graph, const TurnTable &turns, int source, int destination) {
+	return turnAwareRoute(graph, turns, source, std::vector<int>{destination});
+}
+
+size_t loadTurns(Graph *graph, const std::string &filename) {
+	TurnTable *table = new TurnTable();
+	for (const Turn &turn : parseTurns(filename)) {
+		Vertex *from = graph->findVertexByCode(turn.from);
+		Vertex *via = graph->findVertexByCode(turn.via);
+		Vertex *to = graph->findVertexByCode(turn.to);
+		if (from != nullptr && via != nullptr && to != nullptr && turn.penalty >= 0) {
+			table->add(from->getId(), via->getId(), to->getId(), turn.penalty);
+		}
+	}
+
+	size_t loaded = table->size();
+	graph->setTurns(loaded > 0 ? table : nullptr);
+	if (loaded == 0) {
+		delete table;
+	}
+	return loaded;
+}
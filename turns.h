@@ -0,0 +1,113 @@
+/**
+* @file turns.h
+ * @brief Turn restrictions and turn costs, and the edge-based driving search that honours them.
+ */
+
+#ifndef TURNS_H
+#define TURNS_H
+
+#include <climits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+
+// Penalty of a banned turn
+const int TURN_BANNED = INT_MAX;
+
+/**
+ * @brief Turn rules of a map: for a move from one location through another to a third, a time penalty or a ban.
+ *
+ * Rules are kept by location ID, grouped by the location the turn goes through (the junction), so they stay valid
+ * when the graph is reordered or its weights change. Moves without a rule cost nothing extra.
+ */
+class TurnTable {
+public:
+	/**
+	 * @brief Adds a rule, replacing any rule for the same move.
+	 *
+	 * @param from The ID of the location the move comes from.
+	 * @param via The ID of the junction.
+	 * @param to The ID of the location the move goes to.
+	 * @param penalty The extra time of the turn, or TURN_BANNED.
+	 */
+	void add(int from, int via, int to, int penalty);
+
+	/**
+	 * @brief Tells whether some rule goes through a junction.
+	 */
+	bool hasRules(int via) const;
+
+	/**
+	 * @brief Extra time of a move: 0 without a rule, TURN_BANNED if it is banned.
+	 */
+	int penalty(int from, int via, int to) const;
+
+	size_t size() const;
+
+private:
+	struct Rule {
+		int from;
+		int to;
+		int penalty;
+	};
+
+	std::unordered_map<int, std::vector<Rule>> rules;
+	size_t count = 0;
+};
+
+/**
+ * @brief Tells whether a route makes no banned or penalized turn.
+ *
+ * @param turns The turn rules.
+ * @param route The route, as location IDs.
+ */
+bool turnFree(const TurnTable &turns, const Route &route);
+
+/**
+ * @brief Computes the best driving route between two locations, with turn rules.
+ *
+ * The search is edge-based only where it has to be: a junction with rules has one state per edge arriving at it,
+ * since the turns allowed there depend on where the route comes from, and every other location keeps a single
+ * state. States are created as they are reached, so no line graph is built. Closed locations and segments are
+ * taken into account. The time complexity is O((V' + E') log V'), where V' counts the states (V plus the edges
+ * into junctions with rules) and E' their outgoing moves.
+ *
+ * @param graph The graph.
+ * @param turns The turn rules.
+ * @param source The ID of the source location.
+ * @param destination The ID of the destination location.
+ * @return The route, with time -1 if there is none (ROUTE_TIMED_OUT if the query deadline expired); its time
+ *         includes the turn penalties.
+ */
+Route turnAwareRoute(const Graph *graph, const TurnTable &turns, int source, int destination);
+
+/**
+ * @brief Computes the best driving route from a source through stops in a given order, with turn rules.
+ *
+ * The same search as turnAwareRoute(), with the number of stops already visited added to each state, so the turn
+ * a route makes through a stop obeys the rules as well. States grow to k + 1 times as many for k stops.
+ *
+ * @param graph The graph.
+ * @param turns The turn rules.
+ * @param source The ID of the source location.
+ * @param stops The IDs of the stops, in visiting order, the destination last.
+ * @return The route, with time -1 if there is none (ROUTE_TIMED_OUT if the query deadline expired); its time
+ *         includes the turn penalties.
+ */
+Route turnAwareRoute(const Graph *graph, const TurnTable &turns, int source, const std::vector<int> &stops);
+
+/**
+ * @brief Reads turn rules from a CSV file (see parseTurns) and gives them to the graph.
+ *
+ * Rules with unknown location codes or negative penalties are skipped. Without any rule left the graph gets no
+ * table, so driving searches stay node-based.
+ *
+ * @param graph The graph.
+ * @param filename The path to the turns CSV file.
+ * @return The number of rules loaded.
+ */
+size_t loadTurns(Graph *graph, const std::string &filename);
+
+#endif //TURNS_H
@@ -0,0 +1,64 @@
+#include "vertexOrder.h"
+#include <algorithm>
+
+std::vector<int> cuthillMcKeeOrder(const Graph *graph) {
+	const std::vector<Vertex *> &vertices = graph->getVertexSet();
+	int n = vertices.size();
+
+	std::vector<std::vector<int>> neighbours(n);
+	for (int v = 0; v < n; v++) {
+		for (auto e : vertices[v]->getAdj()) {
+			neighbours[v].push_back(e->getDest()->getIndex());
+		}
+		for (auto e : vertices[v]->getIncoming()) {
+			neighbours[v].push_back(e->getOrig()->getIndex());
+		}
+	}
+
+	std::vector<int> degree(n);
+	for (int v = 0; v < n; v++) {
+		std::sort(neighbours[v].begin(), neighbours[v].end());
+		neighbours[v].erase(std::unique(neighbours[v].begin(), neighbours[v].end()), neighbours[v].end());
+		degree[v] = neighbours[v].size();
+	}
+	auto byDegree = [&](int a, int b) {
+		return degree[a] != degree[b] ? degree[a] < degree[b] : a < b;
+	};
+
+	// Components are started from their vertex of minimum degree
+	std::vector<int> starts(n);
+	for (int v = 0; v < n; v++) {
+		starts[v] = v;
+	}
+	std::sort(starts.begin(), starts.end(), byDegree);
+
+	std::vector<int> order;
+	std::vector<bool> visited(n, false);
+	order.reserve(n);
+
+	for (int start : starts) {
+		if (visited[start]) {
+			continue;
+		}
+		visited[start] = true;
+		order.push_back(start);
+
+		for (size_t head = order.size() - 1; head < order.size(); head++) {
+			size_t first = order.size();
+			for (int u : neighbours[order[head]]) {
+				if (!visited[u]) {
+					visited[u] = true;
+					order.push_back(u);
+				}
+			}
+			std::sort(order.begin() + first, order.end(), byDegree);
+		}
+	}
+
+	std::reverse(order.begin(), order.end());
+	return order;
+}
+
+void reorderForLocality(Graph *graph) {
+	graph->reorderVertices(cuthillMcKeeOrder(graph));
+}
@@ -0,0 +1,35 @@
+/**
+* @file vertexOrder.h
+ * @brief Vertex reordering for cache locality: neighbours on the map get nearby dense indices.
+ */
+
+#ifndef VERTEXORDER_H
+#define VERTEXORDER_H
+
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Computes a reverse Cuthill-McKee order of the vertices.
+ *
+ * Each connected component is traversed breadth-first from a vertex of minimum degree, visiting the
+ * neighbours of a vertex by increasing degree; the resulting order is reversed. Roads are treated as
+ * undirected. The time complexity is O(V + E log D), where D is the maximum degree.
+ *
+ * @param graph The graph.
+ * @return order[i] is the current index of the vertex to be placed at index i.
+ */
+std::vector<int> cuthillMcKeeOrder(const Graph *graph);
+
+/**
+ * @brief Renumbers the dense indices of the graph in reverse Cuthill-McKee order.
+ *
+ * Meant to be run once, right after fileToGraph. IDs and codes do not change, so the input and output
+ * of the route queries are the same; the index-based structures (snapshots, matrices, hierarchies)
+ * built afterwards access memory with better locality.
+ *
+ * @param graph The graph to be reordered.
+ */
+void reorderForLocality(Graph *graph);
+
+#endif //VERTEXORDER_H
@@ -0,0 +1,344 @@
+#include "waypoints.h"
+#include "treeCache.h"
+#include "turns.h"
+#include "deadline.h"
+#include "trace.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// Largest number of stops ordered exactly; the dynamic programming table has 2^k * k entries
+const int EXACT_ORDER_MAX_WAYPOINTS = 12;
+
+const long UNREACHABLE = INT_MAX;
+
+// Total time of visiting the stops in the given order, UNREACHABLE if some leg is impossible
+
+long orderTime(const DistanceTable &table, const std::vector<int> &order) {
+	int k = order.size();
+	long total = table.at(0, order[0]);
+	for (int i = 0; i + 1 < k && total < UNREACHABLE; i++) {
+		total += table.at(order[i] + 1, order[i + 1]);
+	}
+	total += table.at(order[k - 1] + 1, k);
+	return std::min(total, UNREACHABLE);
+}
+
+std::vector<int> exactOrder(const DistanceTable &table, int k) {
+	std::vector<std::vector<long>> best(1 << k, std::vector<long>(k, UNREACHABLE));
+	std::vector<std::vector<int>> previous(1 << k, std::vector<int>(k, -1));
+
+	for (int j = 0; j < k; j++) {
+		best[1 << j][j] = table.at(0, j);
+	}
+
+	for (int mask = 1; mask < (1 << k); mask++) {
+		for (int j = 0; j < k; j++) {
+			if (!(mask & 1 << j) || best[mask][j] >= UNREACHABLE) {
+				continue;
+			}
+			for (int next = 0; next < k; next++) {
+				long leg = table.at(j + 1, next);
+				if (mask & 1 << next || leg >= UNREACHABLE) {
+					continue;
+				}
+				int nextMask = mask | 1 << next;
+				if (best[mask][j] + leg < best[nextMask][next]) {
+					best[nextMask][next] = best[mask][j] + leg;
+					previous[nextMask][next] = j;
+				}
+			}
+		}
+	}
+
+	int full = (1 << k) - 1;
+	int last = 0;
+	long bestTime = UNREACHABLE;
+	for (int j = 0; j < k; j++) {
+		if (best[full][j] < UNREACHABLE && best[full][j] + table.at(j + 1, k) < bestTime) {
+			bestTime = best[full][j] + table.at(j + 1, k);
+			last = j;
+		}
+	}
+
+	std::vector<int> order;
+	for (int mask = full, j = last; j != -1; ) {
+		order.push_back(j);
+		int prev = previous[mask][j];
+		mask &= ~(1 << j);
+		j = prev;
+	}
+	std::reverse(order.begin(), order.end());
+
+	// With no feasible order the reconstruction stops early; any complete order will do
+	if ((int)order.size() < k) {
+		order.resize(k);
+		for (int j = 0; j < k; j++) {
+			order[j] = j;
+		}
+	}
+	return order;
+}
+
+std::vector<int> heuristicOrder(const DistanceTable &table, int k) {
+	std::vector<int> order;
+	std::vector<bool> used(k, false);
+
+	for (int row = 0; (int)order.size() < k; ) {
+		int next = -1;
+		for (int j = 0; j < k; j++) {
+			if (!used[j] && (next == -1 || table.at(row, j) < table.at(row, next))) {
+				next = j;
+			}
+		}
+		used[next] = true;
+		order.push_back(next);
+		row = next + 1;
+	}
+
+	// Legs are not symmetric after closures, so each 2-opt move is checked on the whole order
+	long time = orderTime(table, order);
+	for (bool improved = true; improved; ) {
+		improved = false;
+		for (int i = 0; i < k - 1; i++) {
+			for (int j = i + 1; j < k; j++) {
+				std::reverse(order.begin() + i, order.begin() + j + 1);
+				long candidate = orderTime(table, order);
+				if (candidate < time) {
+					time = candidate;
+					improved = true;
+				}
+				else {
+					std::reverse(order.begin() + i, order.begin() + j + 1);
+				}
+			}
+		}
+	}
+	return order;
+}
+
+// Route through the stops in the given order, the destination last, as one Dijkstra over (location, stops reached)
+// states, the node-based counterpart of the staged turnAwareRoute(). The search goes on from each stop with the
+// states it already has, rather than starting a new search per leg. States get an index the first time they are
+// reached, so only the touched ones hold a distance and a parent.
+
+Route stagedRoute(const Graph *graph, Metric metric, int source, const std::vector<int> &stops) {
+	TraceSpan span("stagedSearch");
+	Vertex *src = graph->findVertexById(source);
+	if (src == nullptr || src->isClosed()) {
+		return {{}, 0, -1};
+	}
+	for (int stop : stops) {
+		if (graph->findVertexById(stop) == nullptr) {
+			return {{}, 0, -1};
+		}
+	}
+
+	// Stops reached by arriving at a location, from a count of stops already reached
+	int done = stops.size();
+	auto advance = [&](int stage, Vertex *v) {
+		while (stage < done && stops[stage] == v->getId()) {
+			stage++;
+		}
+		return stage;
+	};
+
+	std::vector<Vertex *> stateVertex;
+	std::vector<int> stateStage;
+	std::vector<long> dist;
+	std::vector<int> parent;
+	std::vector<int> stateIndex((size_t)graph->getNumVertex() * (done + 1), -1);
+
+	auto stateOf = [&](Vertex *v, int stage) {
+		int &state = stateIndex[(size_t)stage * graph->getNumVertex() + v->getIndex()];
+		if (state == -1) {
+			state = stateVertex.size();
+			stateVertex.push_back(v);
+			stateStage.push_back(stage);
+			dist.push_back(LONG_MAX);
+			parent.push_back(-1);
+		}
+		return state;
+	};
+
+	using Entry = std::pair<long, int>;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	int first = stateOf(src, advance(0, src));
+	dist[first] = 0;
+	queue.push({0, first});
+	DeadlinePoll interrupted;
+
+	// Once a state with more stops is settled, the stop it went through is reached at its best time; a state with
+	// fewer stops settled later is at least as far, so any route from it is no better and it is skipped. Each leg
+	// thus ends at its stop, as a separate search would, and the next one goes on in the same queue
+	int reached = -1;
+	int furthest = 0;
+	while (!queue.empty()) {
+		auto [d, s] = queue.top();
+		queue.pop();
+		if (d > dist[s] || stateStage[s] < furthest) {
+			continue;
+		}
+		furthest = stateStage[s];
+		if (furthest == done) {
+			reached = s;
+			break;
+		}
+
+		for (Edge *e : stateVertex[s]->getAdj()) {
+			if (interrupted()) {
+				return {{}, 0, ROUTE_TIMED_OUT};
+			}
+			int w = e->getWeight(metric);
+			if (w == INT_MAX) {
+				continue;
+			}
+
+			int next = stateOf(e->getDest(), advance(stateStage[s], e->getDest()));
+			if (d + w < dist[next]) {
+				dist[next] = d + w;
+				parent[next] = s;
+				queue.push({dist[next], next});
+			}
+		}
+	}
+
+	if (reached == -1) {
+		return {{}, 0, -1};
+	}
+
+	std::vector<int> route;
+	for (int s = reached; s != -1; s = parent[s]) {
+		route.push_back(stateVertex[s]->getId());
+	}
+	std::reverse(route.begin(), route.end());
+	return {route, (int)route.size(), (int)dist[reached]};
+}
+
+// With turn rules, a driving leg that makes a banned or penalized turn is searched again with turnAwareRoute()
+
+Route turnCheckedLeg(const Graph *graph, Metric metric, Route leg) {
+	const TurnTable *turns = graph->getTurns();
+	if (metric != Metric::Driving || turns == nullptr || leg.time < 0 || turnFree(*turns, leg)) {
+		return leg;
+	}
+	return turnAwareRoute(graph, *turns, leg.r[0], leg.r[leg.length - 1]);
+}
+
+}
+
+LegSearch::LegSearch(const Graph *graph, Metric metric) : graph(graph), metric(metric),
+	search(graph->getNumVertex()) {}
+
+bool LegSearch::settle(int target) {
+	TraceSpan span("legSearch");
+	if (metric == Metric::Driving) {
+		searchKernel<DrivingWeight>(graph, search, AllEdges(), StopAtTarget{target});
+	}
+	else {
+		searchKernel<WalkingWeight>(graph, search, AllEdges(), StopAtTarget{target});
+	}
+	return search.isSettled(target);
+}
+
+Route LegSearch::route(int source, int destination) {
+	if (const ShortestPathTree *tree = findCachedTree(graph, metric, source)) {
+		return tree->route(graph, source, destination);
+	}
+
+	if (source != this->source) {
+		this->source = source;
+		search.clear();
+		Vertex *src = graph->findVertexById(source);
+		if (src != nullptr && !src->isClosed()) {
+			search.start(src->getIndex());
+		}
+	}
+
+	Vertex *dest = graph->findVertexById(destination);
+	if (dest == nullptr) {
+		return {{}, 0, -1};
+	}
+	if (!settle(dest->getIndex())) {
+		return {{}, 0, queryInterrupted() ? ROUTE_TIMED_OUT : -1};
+	}
+
+	std::vector<int> route;
+	for (Edge *cur = search.parent(dest->getIndex()); cur != nullptr; cur = search.parent(cur->getOrig()->getIndex())) {
+		route.push_back(cur->getDest()->getId());
+	}
+	route.push_back(source);
+	std::reverse(route.begin(), route.end());
+
+	return {route, (int)route.size(), (int)search.dist(dest->getIndex())};
+}
+
+DistanceTable waypointTable(const Graph *graph, Metric metric, int source, const std::vector<int> &waypoints,
+							int destination) {
+	DistanceTable table;
+	table.sources.push_back(source);
+	table.sources.insert(table.sources.end(), waypoints.begin(), waypoints.end());
+	table.targets = waypoints;
+	table.targets.push_back(destination);
+
+	LegSearch search(graph, metric);
+	for (int row : table.sources) {
+		for (int col : table.targets) {
+			Route route = turnCheckedLeg(graph, metric, search.route(row, col));
+			table.dist.push_back(route.time < 0 ? INT_MAX : route.time);
+			table.routes.push_back(std::move(route));
+		}
+	}
+	return table;
+}
+
+std::vector<int> bestWaypointOrder(const DistanceTable &table) {
+	int k = table.targets.size() - 1;
+	if (k == 0) {
+		return {};
+	}
+	return k <= EXACT_ORDER_MAX_WAYPOINTS ? exactOrder(table, k) : heuristicOrder(table, k);
+}
+
+Route waypointRoute(const Graph *graph, Metric metric, int source, const std::vector<int> &waypoints,
+					int destination, bool bestOrder) {
+	std::vector<int> stops;
+	Route route;
+
+	if (bestOrder && waypoints.size() > 1) {
+		DistanceTable table = waypointTable(graph, metric, source, waypoints, destination);
+		std::vector<int> order = bestWaypointOrder(table);
+
+		std::vector<Route> legs;
+		int row = 0;
+		for (int j : order) {
+			legs.push_back(table.routeAt(row, j));
+			stops.push_back(waypoints[j]);
+			row = j + 1;
+		}
+		legs.push_back(table.routeAt(row, waypoints.size()));
+
+		route = legs[0];
+		for (size_t i = 1; i < legs.size() && route.time >= 0; i++) {
+			if (legs[i].time < 0) {
+				return {{}, 0, legs[i].time};
+			}
+			mergeRoutes(route, legs[i]);
+		}
+		stops.push_back(destination);
+	}
+	else {
+		stops = waypoints;
+		stops.push_back(destination);
+		route = stagedRoute(graph, metric, source, stops);
+	}
+
+	// Rules only ever add time or remove moves, so a route through the stops that meets none of them is the best one
+	// for its order; otherwise the stops are searched through again, edge-based, so turns at the stops count too
+	const TurnTable *turns = graph->getTurns();
+	if (metric == Metric::Driving && turns != nullptr && route.time >= 0 && !turnFree(*turns, route)) {
+		return turnAwareRoute(graph, *turns, source, stops);
+	}
+	return route;
+}
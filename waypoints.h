@@ -0,0 +1,94 @@
+/**
+* @file waypoints.h
+ * @brief Routes through several mandatory stops, in a fixed order or in the best order.
+ */
+
+#ifndef WAYPOINTS_H
+#define WAYPOINTS_H
+
+#include <vector>
+#include "Graph.h"
+#include "route.h"
+#include "distanceTable.h"
+#include "searchKernel.h"
+
+/**
+ * @brief Point-to-point Dijkstra that keeps its state between queries.
+ *
+ * A query stops as soon as its target is settled. A following query from the same source resumes the search
+ * where it stopped, and a query from another source only resets the vertices the previous one touched, so a
+ * sequence of legs never pays for a full initialization of the graph. Closed locations and segments are
+ * taken into account.
+ */
+class LegSearch {
+public:
+	LegSearch(const Graph *graph, Metric metric);
+
+	/**
+	 * @brief Computes the best route between two locations.
+	 *
+	 * @param source The ID of the source location.
+	 * @param destination The ID of the destination location.
+	 * @return The route, with time -1 if there is none, or ROUTE_TIMED_OUT if the query deadline expired.
+	 */
+	Route route(int source, int destination);
+
+private:
+	bool settle(int target);
+
+	const Graph *graph;
+	Metric metric;
+	int source = -1;
+	SearchBuffers<> search;
+};
+
+/**
+ * @brief Computes the table of best routes between the endpoints and the stops of a route.
+ *
+ * Row 0 is the source and row i the stop i - 1; column j < k is the stop j and column k the destination.
+ * Each row is a single search, resumed until every column is settled. With turn rules, driving routes that make a
+ * banned or penalized turn are searched again with turnAwareRoute().
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source location.
+ * @param waypoints The IDs of the k stops.
+ * @param destination The ID of the destination location.
+ * @return The table, with the routes.
+ */
+DistanceTable waypointTable(const Graph *graph, Metric metric, int source, const std::vector<int> &waypoints,
+							int destination);
+
+/**
+ * @brief Finds the order of the stops that minimizes the total time, given their waypointTable().
+ *
+ * Up to 12 stops, the order is exact (Held-Karp dynamic programming, O(2^k k^2)). Above that, it is built by
+ * nearest neighbour and improved with 2-opt moves.
+ *
+ * @param table The table returned by waypointTable().
+ * @return The stops in visiting order, as indices into the waypoint list.
+ */
+std::vector<int> bestWaypointOrder(const DistanceTable &table);
+
+/**
+ * @brief Computes the best route from a source to a destination that goes through every stop.
+ *
+ * In the given order, the route is a single search over (location, stops reached) states, which goes on from each
+ * stop rather than starting a search per leg. In the best order, the legs come from waypointTable().
+ *
+ * With turn rules, a driving route that makes a banned or penalized turn, at a stop or elsewhere, is searched again
+ * through the same stops with turnAwareRoute(). In the best order, the order is chosen on the times between stops,
+ * without the turns at the stops.
+ *
+ * @param graph The graph.
+ * @param metric The weight to use.
+ * @param source The ID of the source location.
+ * @param waypoints The IDs of the stops.
+ * @param destination The ID of the destination location.
+ * @param bestOrder If true, the stops may be visited in any order; otherwise in the given order.
+ * @return The route, with time -1 if some leg is impossible.
+ */
+Route waypointRoute(const Graph *graph, Metric metric, int source, const std::vector<int> &waypoints,
+					int destination, bool bestOrder);
+
+#endif //WAYPOINTS_H
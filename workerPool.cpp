@@ -0,0 +1,92 @@
+#include "workerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned i = 1; i < threads; i++) {
+		workers.emplace_back(&WorkerPool::workerLoop, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start.notify_all();
+
+	for (auto &t : workers) {
+		t.join();
+	}
+}
+
+unsigned WorkerPool::size() const {
+	return workers.size() + 1;
+}
+
+WorkerPool &WorkerPool::shared() {
+	static WorkerPool pool;
+	return pool;
+}
+
+void WorkerPool::run(size_t count, const Task &task, size_t grain) {
+	if (workers.empty() || count <= grain) {
+		task(0, count, 0);
+		return;
+	}
+
+	// Loops from different threads take turns, the pool runs one at a time
+	std::lock_guard<std::mutex> turn(runMutex);
+	std::unique_lock<std::mutex> lock(mutex);
+	current = &task;
+	total = count;
+	chunk = std::max(grain, count / (4 * size()));
+	next = 0;
+	pending = workers.size();
+	generation++;
+	lock.unlock();
+	start.notify_all();
+
+	work(0);
+
+	lock.lock();
+	done.wait(lock, [this] { return pending == 0; });
+	current = nullptr;
+}
+
+void WorkerPool::work(unsigned worker) {
+	while (true) {
+		size_t begin = next.fetch_add(chunk);
+		if (begin >= total) {
+			break;
+		}
+		(*current)(begin, std::min(total, begin + chunk), worker);
+	}
+}
+
+void WorkerPool::workerLoop(unsigned worker) {
+	unsigned seen = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+
+		work(worker);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--pending == 0) {
+				done.notify_one();
+			}
+		}
+	}
+}
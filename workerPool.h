@@ -0,0 +1,81 @@
+/**
+* @file workerPool.h
+ * @brief A small pool of persistent worker threads used by the parallel search algorithms.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of persistent threads that runs parallel loops over an index range.
+ *
+ * The calling thread takes part in every loop as worker 0, so a pool of size 1 runs everything
+ * inline. The range is handed out in chunks through an atomic counter, which keeps the threads busy
+ * even when the cost per index is uneven, as it is when relaxing vertices of different degree.
+ */
+class WorkerPool {
+public:
+	/**
+	 * @brief Task run on a sub-range [begin, end) by the worker with the given number.
+	 */
+	using Task = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+	/**
+	 * @brief Creates a pool with the given number of threads (0 uses the hardware concurrency).
+	 */
+	explicit WorkerPool(unsigned threads = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	/**
+	 * @brief Number of workers, including the calling thread.
+	 */
+	unsigned size() const;
+
+	/**
+	 * @brief Runs the task over [0, count) and waits for it to finish.
+	 *
+	 * Ranges with at most `grain` indexes are run inline by the calling thread. Calls from several threads are
+	 * run one after the other; a task must not call run() on the same pool.
+	 *
+	 * @param count The number of indexes.
+	 * @param task The task to run on each chunk.
+	 * @param grain The minimum chunk size.
+	 */
+	void run(size_t count, const Task &task, size_t grain = 256);
+
+	/**
+	 * @brief Pool shared by the algorithms, sized to the hardware concurrency.
+	 */
+	static WorkerPool &shared();
+
+private:
+	void workerLoop(unsigned worker);
+	void work(unsigned worker);
+
+	std::vector<std::thread> workers;
+	std::mutex runMutex;
+	std::mutex mutex;
+	std::condition_variable start;
+	std::condition_variable done;
+
+	const Task *current = nullptr;
+	size_t total = 0;
+	size_t chunk = 1;
+	std::atomic<size_t> next{0};
+	unsigned generation = 0;
+	unsigned pending = 0;
+	bool stopping = false;
+};
+
+#endif //WORKERPOOL_H